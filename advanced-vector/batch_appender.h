@@ -0,0 +1,105 @@
+#pragma once
+#include "small_vector.h"
+#include "vector.h"
+
+#include <iterator>
+#include <mutex>
+
+namespace detail {
+
+// Пакет по умолчанию занимает около 4 КБ
+template <typename T>
+constexpr size_t Default_Batch_Size() noexcept {
+    return std::max<size_t>(BASE_PAGE_SIZE / sizeof(T), 1);
+}
+
+}  // namespace detail
+
+// Пакетная запись в общий Vector из многих потоков. Каждый поток держит свой BatchAppender и добавляет
+// элементы в его встроенный буфер (SmallVector), не обращаясь к общей памяти. Когда в буфере набирается
+// BatchSize элементов или вызван Flush, пакет переносится в конец target под mutex одним Append,
+// поэтому захват блокировки и перевыделение буфера target приходятся на пакет, а не на элемент.
+// Порядок элементов сохраняется внутри пакета, пакеты разных потоков чередуются произвольно.
+// Деструктор записывает оставшиеся элементы; чтобы узнать об ошибке записи, вызовите Flush явно
+template <typename T, size_t BatchSize = detail::Default_Batch_Size<T>(), typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DoublingGrowth>
+class BatchAppender {
+public:
+    using Target = Vector<T, Allocator, GrowthPolicy>;
+
+    static constexpr size_t BATCH_SIZE = BatchSize;
+
+    // target и mutex должны пережить BatchAppender; все записи в target должны идти под этим mutex
+    BatchAppender(Target& target, std::mutex& mutex) noexcept
+        : target_(&target)
+        , mutex_(&mutex) {
+    }
+
+    BatchAppender(const BatchAppender&) = delete;
+    BatchAppender& operator=(const BatchAppender&) = delete;
+
+    ~BatchAppender();
+
+    void PushBack(const T& value);
+    void PushBack(T&& value);
+
+    // Ссылка действительна до записи пакета, поэтому args не должны ссылаться на элементы буфера
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+    // Переносит накопленные элементы в target. При исключении target не изменяется, элементы остаются
+    // в буфере, если перемещение T не выбрасывает исключений
+    void Flush();
+
+    // Число элементов, ещё не записанных в target
+    size_t Pending() const noexcept {
+        return buffer_.Size();
+    }
+
+private:
+    Target* target_;
+    std::mutex* mutex_;
+    SmallVector<T, BatchSize> buffer_;
+};
+
+
+template <typename T, size_t BatchSize, typename Allocator, typename GrowthPolicy>
+BatchAppender<T, BatchSize, Allocator, GrowthPolicy>::~BatchAppender() {
+    try {
+        Flush();
+    } catch (...) {
+        // Деструктор не может сообщить об ошибке, оставшиеся элементы теряются
+    }
+}
+
+template <typename T, size_t BatchSize, typename Allocator, typename GrowthPolicy>
+void BatchAppender<T, BatchSize, Allocator, GrowthPolicy>::PushBack(const T& value) {
+    EmplaceBack(value);
+}
+
+template <typename T, size_t BatchSize, typename Allocator, typename GrowthPolicy>
+void BatchAppender<T, BatchSize, Allocator, GrowthPolicy>::PushBack(T&& value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T, size_t BatchSize, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+T& BatchAppender<T, BatchSize, Allocator, GrowthPolicy>::EmplaceBack(Args&&... args) {
+    if (buffer_.Size() == BatchSize) {
+        Flush();
+    }
+    // После Flush буфер пуст и остаётся встроенным, память в куче не выделяется
+    return buffer_.EmplaceBack(std::forward<Args>(args)...);
+}
+
+template <typename T, size_t BatchSize, typename Allocator, typename GrowthPolicy>
+void BatchAppender<T, BatchSize, Allocator, GrowthPolicy>::Flush() {
+    if (buffer_.Size() == 0) {
+        return;
+    }
+    {
+        std::lock_guard lock(*mutex_);
+        target_->Append(std::make_move_iterator(buffer_.begin()), std::make_move_iterator(buffer_.end()));
+    }
+    buffer_.Clear();
+}
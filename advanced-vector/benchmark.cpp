@@ -0,0 +1,578 @@
+// Микробенчмарки Vector в сравнении с std::vector на одинаковых сценариях (Google Benchmark).
+// Сборка: g++ -O2 -DNDEBUG -std=c++17 benchmark.cpp -lbenchmark -lpthread -o benchmark
+#include "vector.h"
+#include "batch_appender.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "incremental_vector.h"
+#include "segmented_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
+#include "vector_pool.h"
+#include "simd.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Счётчик обращений к глобальному operator new, через который выделяют память оба контейнера
+size_t num_allocations = 0;
+
+}  // namespace
+
+// GCC принимает пару malloc/free внутри замещённых operator new/delete за несогласованную
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    ++num_allocations;
+    if (void* p = std::malloc(size != 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+// Тривиально копируемый тип
+using Trivial = int;
+
+// Тип, который можно только перемещать
+struct MoveOnly {
+    explicit MoveOnly(int value)
+        : value(std::make_unique<int>(value)) {
+    }
+    int Get() const {
+        return *value;
+    }
+    std::unique_ptr<int> value;
+};
+
+// Тип с потенциально выбрасывающим перемещением: при перевыделении оба контейнера копируют его
+struct ThrowingCopy {
+    explicit ThrowingCopy(int value)
+        : value(value)
+        , payload("payload") {
+    }
+    ThrowingCopy(const ThrowingCopy&) = default;
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+    ThrowingCopy(ThrowingCopy&& other) noexcept(false)
+        : value(other.value)
+        , payload(std::move(other.payload)) {
+    }
+    ThrowingCopy& operator=(ThrowingCopy&& other) noexcept(false) {
+        value = other.value;
+        payload = std::move(other.payload);
+        return *this;
+    }
+    int Get() const {
+        return value;
+    }
+    int value;
+    std::string payload;
+};
+
+int Get(int value) {
+    return value;
+}
+
+template <typename T>
+int Get(const T& value) {
+    return value.Get();
+}
+
+template <typename T>
+T Make(int value) {
+    return T(value);
+}
+
+// Единый интерфейс к двум контейнерам
+template <typename T>
+void Reserve(std::vector<T>& v, size_t capacity) {
+    v.reserve(capacity);
+}
+template <typename T>
+void Reserve(Vector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T>
+void Reserve(SegmentedVector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T>
+void Reserve(IncrementalVector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T, size_t N>
+void Reserve(StaticVector<T, N>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T>
+void PushBack(std::vector<T>& v, T&& value) {
+    v.push_back(std::move(value));
+}
+template <typename T>
+void PushBack(Vector<T>& v, T&& value) {
+    v.PushBack(std::move(value));
+}
+
+template <typename T>
+void PushBack(SegmentedVector<T>& v, T&& value) {
+    v.PushBack(std::move(value));
+}
+
+template <typename T>
+void PushBack(IncrementalVector<T>& v, T&& value) {
+    v.PushBack(std::move(value));
+}
+
+template <typename T, size_t N>
+void PushBack(StaticVector<T, N>& v, T&& value) {
+    v.PushBack(std::move(value));
+}
+
+template <typename T>
+void EmplaceBack(std::vector<T>& v, int value) {
+    v.emplace_back(value);
+}
+template <typename T>
+void EmplaceBack(Vector<T>& v, int value) {
+    v.EmplaceBack(value);
+}
+
+template <typename T>
+void Insert(std::vector<T>& v, size_t pos, T&& value) {
+    v.insert(v.begin() + pos, std::move(value));
+}
+template <typename T>
+void Insert(Vector<T>& v, size_t pos, T&& value) {
+    v.Insert(v.begin() + pos, std::move(value));
+}
+
+template <typename T>
+void Erase(std::vector<T>& v, size_t pos) {
+    v.erase(v.begin() + pos);
+}
+template <typename T>
+void Erase(Vector<T>& v, size_t pos) {
+    v.Erase(v.begin() + pos);
+}
+
+template <typename T>
+void Resize(std::vector<T>& v, size_t size) {
+    v.resize(size);
+}
+template <typename T>
+void Resize(Vector<T>& v, size_t size) {
+    v.Resize(size);
+}
+
+template <typename T>
+size_t Size(const std::vector<T>& v) {
+    return v.size();
+}
+template <typename T>
+size_t Size(const Vector<T>& v) {
+    return v.Size();
+}
+
+template <typename Container>
+using ValueType = std::remove_reference_t<decltype(*std::declval<Container&>().begin())>;
+
+template <typename Container>
+Container MakeFilled(size_t size) {
+    using T = ValueType<Container>;
+    Container v;
+    Reserve(v, size);
+    for (size_t i = 0; i < size; ++i) {
+        PushBack(v, Make<T>(static_cast<int>(i)));
+    }
+    return v;
+}
+
+// Количество выделений памяти в среднем на итерацию
+class AllocationCounter {
+public:
+    AllocationCounter()
+        : start_(num_allocations) {
+    }
+
+    void Report(benchmark::State& state) const {
+        state.counters["allocs/iter"] = benchmark::Counter(static_cast<double>(num_allocations - start_),
+                                                           benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    size_t start_;
+};
+
+template <typename Container, bool WithReserve>
+void BM_PushBack(benchmark::State& state) {
+    using T = ValueType<Container>;
+    const size_t size = state.range(0);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        Container v;
+        if constexpr (WithReserve) {
+            Reserve(v, size);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(v, Make<T>(static_cast<int>(i)));
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container, bool WithReserve>
+void BM_EmplaceBack(benchmark::State& state) {
+    const size_t size = state.range(0);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        Container v;
+        if constexpr (WithReserve) {
+            Reserve(v, size);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            EmplaceBack(v, static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Вставка и удаление одного элемента: range(1) задаёт позицию (0 — начало, 1 — середина, 2 — конец)
+template <typename Container>
+void BM_InsertErase(benchmark::State& state) {
+    using T = ValueType<Container>;
+    const size_t size = state.range(0);
+    const size_t pos = state.range(1) * size / 2;
+    Container v = MakeFilled<Container>(size);
+    Reserve(v, size + 1);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        Insert(v, pos, Make<T>(-1));
+        Erase(v, pos);
+        benchmark::ClobberMemory();
+    }
+    allocations.Report(state);
+}
+
+// Копирующее присваивание в вектор, вместимости которого достаточно
+template <typename Container>
+void BM_CopyAssignReuse(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Container src = MakeFilled<Container>(size);
+    Container dst = MakeFilled<Container>(size);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        dst = src;
+        benchmark::DoNotOptimize(dst);
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container>
+void BM_Resize(benchmark::State& state) {
+    const size_t size = state.range(0);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        Container v;
+        Resize(v, size);
+        Resize(v, size / 2);
+        Resize(v, size);
+        benchmark::DoNotOptimize(v);
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Container>
+void BM_Iterate(benchmark::State& state) {
+    const size_t size = state.range(0);
+    const Container v = MakeFilled<Container>(size);
+    for (auto _ : state) {
+        long long sum = 0;
+        for (const auto& value : v) {
+            sum += Get(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * Size(v));
+}
+
+// Скалярные алгоритмы стандартной библиотеки и ядра simd на одном диапазоне
+template <typename T, bool Simd>
+void BM_Sum(benchmark::State& state) {
+    Vector<T> v(state.range(0));
+    std::iota(v.begin(), v.end(), T{});
+    for (auto _ : state) {
+        if constexpr (Simd) {
+            benchmark::DoNotOptimize(simd::Sum(v));
+        } else {
+            benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), simd::detail::SumType<T>{}));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * v.Size());
+}
+
+template <typename T, bool Simd>
+void BM_Count(benchmark::State& state) {
+    Vector<T> v(state.range(0));
+    std::iota(v.begin(), v.end(), T{});
+    for (auto _ : state) {
+        if constexpr (Simd) {
+            benchmark::DoNotOptimize(simd::Count(v, T{1}));
+        } else {
+            benchmark::DoNotOptimize(std::count(v.begin(), v.end(), T{1}));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * v.Size());
+}
+
+// Запись из многих потоков в один Vector: блокировка на каждый элемент или пакетами через BatchAppender
+template <bool Batched>
+void BM_SharedAppend(benchmark::State& state) {
+    static Vector<Trivial> target;
+    static std::mutex mutex;
+    constexpr int PER_ITERATION = 1024;
+    for (auto _ : state) {
+        if constexpr (Batched) {
+            BatchAppender<Trivial> appender(target, mutex);
+            for (int i = 0; i < PER_ITERATION; ++i) {
+                appender.PushBack(i);
+            }
+        } else {
+            for (int i = 0; i < PER_ITERATION; ++i) {
+                std::lock_guard lock(mutex);
+                target.PushBack(i);
+            }
+        }
+        if (state.thread_index() == 0) {
+            std::lock_guard lock(mutex);
+            target.Clear();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * PER_ITERATION);
+}
+
+// Раздача одного вектора задачам, которые только читают его: полное копирование Vector против CowVector
+template <typename Container>
+void BM_FanOutRead(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Container source;
+    for (size_t i = 0; i < size; ++i) {
+        source.PushBack(static_cast<Trivial>(i));
+    }
+    constexpr int NUM_TASKS = 64;
+    for (auto _ : state) {
+        for (int task = 0; task < NUM_TASKS; ++task) {
+            const Container copy = source;
+            benchmark::DoNotOptimize(copy[task % size]);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_TASKS);
+}
+
+// Обработка запроса, который заполняет временный вектор: новый Vector на каждый запрос против VectorPool
+template <bool Pooled>
+void BM_RequestScratch(benchmark::State& state) {
+    const size_t size = state.range(0);
+    constexpr size_t INITIAL_CAPACITY = 16;
+    VectorPool<Trivial> pool(INITIAL_CAPACITY);
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        auto fill = [size](Vector<Trivial>& scratch) {
+            for (size_t i = 0; i < size; ++i) {
+                scratch.PushBack(static_cast<Trivial>(i));
+            }
+            benchmark::DoNotOptimize(scratch[size - 1]);
+        };
+        if constexpr (Pooled) {
+            auto lease = pool.Acquire();
+            fill(*lease);
+        } else {
+            Vector<Trivial> scratch;
+            scratch.Reserve(INITIAL_CAPACITY);
+            fill(scratch);
+        }
+    }
+    allocations.Report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Поиск по таблице: std::map, FlatMap и FlatMap с индексом Эйтцингера
+enum class LookupTable { STD_MAP, FLAT_MAP, FLAT_MAP_INDEXED };
+
+template <LookupTable Table>
+void BM_Lookup(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    std::map<int, int> tree;
+    FlatMap<int, int> flat;
+    Vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < size; ++i) {
+        pairs.PushBack({i * 2, i});
+        tree.emplace(i * 2, i);
+    }
+    flat.InsertRange(pairs.begin(), pairs.end());
+    if (Table == LookupTable::FLAT_MAP_INDEXED) {
+        flat.BuildIndex();
+    }
+    unsigned seed = 1;
+    for (auto _ : state) {
+        seed = seed * 1103515245 + 12345;
+        const int key = static_cast<int>((seed >> 8) % static_cast<unsigned>(size * 2));
+        if constexpr (Table == LookupTable::STD_MAP) {
+            benchmark::DoNotOptimize(tree.find(key));
+        } else {
+            benchmark::DoNotOptimize(flat.Find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Заполнение FlatMap пакетом InsertRange против вставки по одному ключу
+template <bool Bulk>
+void BM_FlatMapFill(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    Vector<std::pair<int, int>> pairs;
+    unsigned seed = 1;
+    for (int i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        pairs.PushBack({static_cast<int>(seed >> 8), i});
+    }
+    for (auto _ : state) {
+        FlatMap<int, int> flat;
+        if constexpr (Bulk) {
+            flat.InsertRange(pairs.begin(), pairs.end());
+        } else {
+            for (const auto& [key, value] : pairs) {
+                flat.TryEmplace(key, value);
+            }
+        }
+        benchmark::DoNotOptimize(flat.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Сумма одного поля широкой записи: массив структур (Vector) против столбцов SoAVector
+struct WideRecord {
+    int64_t id;
+    double values[7];
+};
+
+template <bool Columns>
+void BM_ScanField(benchmark::State& state) {
+    const size_t size = state.range(0);
+    Vector<WideRecord> rows;
+    SoAVector<int64_t, std::array<double, 7>> columns;
+    for (size_t i = 0; i < size; ++i) {
+        rows.PushBack(WideRecord{static_cast<int64_t>(i), {}});
+        columns.EmplaceBack(static_cast<int64_t>(i), std::array<double, 7>{});
+    }
+    for (auto _ : state) {
+        int64_t sum = 0;
+        if constexpr (Columns) {
+            for (const int64_t id : columns.Column<0>()) {
+                sum += id;
+            }
+        } else {
+            for (const WideRecord& row : rows) {
+                sum += row.id;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+constexpr int MIN_SIZE = 8;
+constexpr int MAX_SIZE = 1 << 16;
+
+#define VECTOR_BENCHMARK_PAIR(NAME, TYPE, ...)                                                \
+    BENCHMARK_TEMPLATE(NAME, std::vector<TYPE>, ##__VA_ARGS__)->Range(MIN_SIZE, MAX_SIZE); \
+    BENCHMARK_TEMPLATE(NAME, Vector<TYPE>, ##__VA_ARGS__)->Range(MIN_SIZE, MAX_SIZE)
+
+#define VECTOR_BENCHMARKS(TYPE)                                                                   \
+    VECTOR_BENCHMARK_PAIR(BM_PushBack, TYPE, false);                                              \
+    VECTOR_BENCHMARK_PAIR(BM_PushBack, TYPE, true);                                               \
+    VECTOR_BENCHMARK_PAIR(BM_EmplaceBack, TYPE, false);                                           \
+    VECTOR_BENCHMARK_PAIR(BM_EmplaceBack, TYPE, true);                                            \
+    BENCHMARK_TEMPLATE(BM_InsertErase, std::vector<TYPE>)->ArgsProduct({{MIN_SIZE, 1024, MAX_SIZE}, {0, 1, 2}}); \
+    BENCHMARK_TEMPLATE(BM_InsertErase, Vector<TYPE>)->ArgsProduct({{MIN_SIZE, 1024, MAX_SIZE}, {0, 1, 2}});      \
+    VECTOR_BENCHMARK_PAIR(BM_Iterate, TYPE)
+
+VECTOR_BENCHMARKS(Trivial);
+VECTOR_BENCHMARKS(MoveOnly);
+VECTOR_BENCHMARKS(ThrowingCopy);
+
+// Копирование и Resize требуют копируемости и конструктора по умолчанию
+VECTOR_BENCHMARK_PAIR(BM_CopyAssignReuse, Trivial);
+VECTOR_BENCHMARK_PAIR(BM_CopyAssignReuse, ThrowingCopy);
+VECTOR_BENCHMARK_PAIR(BM_Resize, Trivial);
+
+// Рост без переноса элементов и с постепенным переносом
+BENCHMARK_TEMPLATE(BM_PushBack, SegmentedVector<Trivial>, false)->Range(MIN_SIZE, MAX_SIZE);
+BENCHMARK_TEMPLATE(BM_PushBack, SegmentedVector<MoveOnly>, false)->Range(MIN_SIZE, MAX_SIZE);
+BENCHMARK_TEMPLATE(BM_PushBack, IncrementalVector<Trivial>, false)->Range(MIN_SIZE, MAX_SIZE);
+BENCHMARK_TEMPLATE(BM_PushBack, IncrementalVector<MoveOnly>, false)->Range(MIN_SIZE, MAX_SIZE);
+
+// Короткие векторы во встроенном буфере, без обращений к куче; сравнивать с BM_PushBack<Vector<Trivial>, true>
+BENCHMARK_TEMPLATE(BM_PushBack, StaticVector<Trivial, 64>, true)->Range(MIN_SIZE, 64);
+
+BENCHMARK_TEMPLATE(BM_SharedAppend, false)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SharedAppend, true)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_FanOutRead, Vector<Trivial>)->Range(MIN_SIZE, MAX_SIZE);
+BENCHMARK_TEMPLATE(BM_FanOutRead, CowVector<Trivial>)->Range(MIN_SIZE, MAX_SIZE);
+
+BENCHMARK_TEMPLATE(BM_RequestScratch, false)->Range(MIN_SIZE, MAX_SIZE);
+BENCHMARK_TEMPLATE(BM_RequestScratch, true)->Range(MIN_SIZE, MAX_SIZE);
+
+BENCHMARK_TEMPLATE(BM_Lookup, LookupTable::STD_MAP)->Range(MIN_SIZE, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Lookup, LookupTable::FLAT_MAP)->Range(MIN_SIZE, 1 << 20);
+BENCHMARK_TEMPLATE(BM_Lookup, LookupTable::FLAT_MAP_INDEXED)->Range(MIN_SIZE, 1 << 20);
+BENCHMARK_TEMPLATE(BM_FlatMapFill, false)->Range(MIN_SIZE, MAX_SIZE);
+BENCHMARK_TEMPLATE(BM_FlatMapFill, true)->Range(MIN_SIZE, MAX_SIZE);
+
+BENCHMARK_TEMPLATE(BM_ScanField, false)->Range(1024, 1 << 20);
+BENCHMARK_TEMPLATE(BM_ScanField, true)->Range(1024, 1 << 20);
+
+#define SIMD_BENCHMARK_PAIR(NAME, TYPE)                                   \
+    BENCHMARK_TEMPLATE(NAME, TYPE, false)->Range(MIN_SIZE, MAX_SIZE); \
+    BENCHMARK_TEMPLATE(NAME, TYPE, true)->Range(MIN_SIZE, MAX_SIZE)
+
+SIMD_BENCHMARK_PAIR(BM_Sum, uint8_t);
+SIMD_BENCHMARK_PAIR(BM_Sum, float);
+SIMD_BENCHMARK_PAIR(BM_Count, uint8_t);
+SIMD_BENCHMARK_PAIR(BM_Count, int32_t);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,263 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <memory>
+
+namespace detail {
+
+inline size_t Floor_Log2(size_t value) noexcept {
+    assert(value != 0);
+#if defined(__GNUC__)
+    return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(value));
+#else
+    size_t result = 0;
+    while (value >>= 1) {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+}  // namespace detail
+
+// Вектор только для добавления, в который многие потоки пишут без блокировок. Добавление занимает ячейку
+// атомарным fetch_add и создаёт элемент в ней; после этого элемент опубликован, и его можно читать из
+// любого потока. Память состоит из сегментов RawMemory, каждый следующий вдвое больше предыдущего:
+// сегмент k начинается с индекса first * (2^k - 1), где first — вместимость первого сегмента.
+// Сегмент создаёт первый поток, которому он понадобился, и устанавливает его через compare_exchange,
+// поэтому рост не блокирует других писателей и не перемещает опубликованные элементы.
+// Если конструктор T выбросил исключение, занятая ячейка остаётся неопубликованной, её пропускают
+// Snapshot и Freeze
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentVector {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    static constexpr size_t DEFAULT_FIRST_SEGMENT = 64;
+
+    // Вместимость первого сегмента округляется вверх до степени двойки. Если итоговый размер известен
+    // заранее, первый сегмент такого размера позволяет Freeze отдать буфер без копирования
+    explicit ConcurrentVector(size_t first_segment = DEFAULT_FIRST_SEGMENT, const Allocator& alloc = Allocator());
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector();
+
+    // Безопасны при одновременном вызове из разных потоков
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+    // Возвращают индекс добавленного элемента
+    size_t PushBack(const T& value);
+    size_t PushBack(T&& value);
+
+    // Число занятых ячеек; элементы в некоторых из них могут ещё создаваться
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Элемент создан и виден читающему потоку
+    bool IsPublished(size_t index) const noexcept;
+
+    // Опубликованный элемент или nullptr
+    const T* TryGet(size_t index) const noexcept;
+    T* TryGet(size_t index) noexcept;
+
+    // Индекс должен быть опубликован: получен из PushBack этого потока или проверен IsPublished
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(IsPublished(index));
+        return *Slot(index);
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Копирует опубликованные элементы в порядке индексов; можно вызывать во время добавления
+    Vector<T, Allocator> Snapshot() const;
+
+    // Переносит элементы в Vector и оставляет *this пустым; одновременных добавлений быть не должно.
+    // Если все элементы лежат в первом сегменте без пропусков, Vector принимает его буфер без копирования,
+    // иначе элементы перемещаются в новый буфер
+    Vector<T, Allocator> Freeze() &&;
+
+private:
+    struct Segment {
+        Segment(size_t capacity, const Allocator& alloc)
+            : data(capacity, alloc)
+            , published(std::make_unique<std::atomic<bool>[]>(capacity)) {
+        }
+
+        RawMemory<T, Allocator> data;
+        std::unique_ptr<std::atomic<bool>[]> published;
+    };
+
+    // Сегменты до 2^63 элементов при первом сегменте из одного элемента
+    static constexpr size_t MAX_SEGMENTS = sizeof(size_t) * 8;
+
+    Allocator alloc_;
+    size_t first_shift_ = 0;
+    std::atomic<size_t> size_{0};
+    std::atomic<Segment*> segments_[MAX_SEGMENTS] = {};
+
+    size_t First_Segment() const noexcept {
+        return size_t{1} << first_shift_;
+    }
+
+    // Номер сегмента и позиция в нём
+    std::pair<size_t, size_t> Locate(size_t index) const noexcept {
+        const size_t segment = detail::Floor_Log2((index >> first_shift_) + 1);
+        return {segment, index - (((size_t{1} << segment) - 1) << first_shift_)};
+    }
+
+    T* Slot(size_t index) const noexcept {
+        const auto [segment, offset] = Locate(index);
+        return segments_[segment].load(std::memory_order_acquire)->data.GetAddress() + offset;
+    }
+
+    Segment& Get_Segment(size_t segment);
+    // Занимает ячейку, создаёт в ней элемент и публикует его; возвращает индекс и адрес элемента
+    template <typename... Args>
+    std::pair<size_t, T*> Emplace_Slot(Args&&... args);
+    // Разрушает опубликованные элементы и освобождает сегменты
+    void Destroy_All() noexcept;
+};
+
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>::ConcurrentVector(size_t first_segment, const Allocator& alloc)
+    : alloc_(alloc) //
+{
+    while ((size_t{1} << first_shift_) < first_segment) {
+        ++first_shift_;
+    }
+}
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>::~ConcurrentVector() {
+    Destroy_All();
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+T& ConcurrentVector<T, Allocator>::EmplaceBack(Args&&... args) {
+    return *Emplace_Slot(std::forward<Args>(args)...).second;
+}
+
+template <typename T, typename Allocator>
+size_t ConcurrentVector<T, Allocator>::PushBack(const T& value) {
+    return Emplace_Slot(value).first;
+}
+
+template <typename T, typename Allocator>
+size_t ConcurrentVector<T, Allocator>::PushBack(T&& value) {
+    return Emplace_Slot(std::move(value)).first;
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentVector<T, Allocator>::IsPublished(size_t index) const noexcept {
+    if (index >= Size()) {
+        return false;
+    }
+    const auto [segment_index, offset] = Locate(index);
+    const Segment* segment = segments_[segment_index].load(std::memory_order_acquire);
+    return segment != nullptr && segment->published[offset].load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator>
+const T* ConcurrentVector<T, Allocator>::TryGet(size_t index) const noexcept {
+    return const_cast<ConcurrentVector&>(*this).TryGet(index);
+}
+
+template <typename T, typename Allocator>
+T* ConcurrentVector<T, Allocator>::TryGet(size_t index) noexcept {
+    return IsPublished(index) ? Slot(index) : nullptr;
+}
+
+template <typename T, typename Allocator>
+Vector<T, Allocator> ConcurrentVector<T, Allocator>::Snapshot() const {
+    const size_t size = Size();
+    Vector<T, Allocator> result(alloc_);
+    result.Reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        if (const T* elem = TryGet(i)) {
+            result.EmplaceBack(*elem);
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Allocator>
+Vector<T, Allocator> ConcurrentVector<T, Allocator>::Freeze() && {
+    const size_t size = Size();
+    size_t num_published = 0;
+    for (size_t i = 0; i < size; ++i) {
+        num_published += IsPublished(i) ? 1 : 0;
+    }
+    if (size != 0 && size <= First_Segment() && num_published == size) {
+        // Все элементы в первом сегменте: его буфер выделен тем же аллокатором и переходит к Vector
+        std::unique_ptr<Segment> segment(segments_[0].exchange(nullptr, std::memory_order_acq_rel));
+        const size_t capacity = segment->data.Capacity();
+        T* data = segment->data.Release();
+        Destroy_All();
+        return Vector<T, Allocator>::FromRawBuffer(data, size, capacity, alloc_);
+    }
+    Vector<T, Allocator> result(alloc_);
+    result.Reserve(num_published);
+    for (size_t i = 0; i < size; ++i) {
+        if (T* elem = TryGet(i)) {
+            result.EmplaceBack(std::move_if_noexcept(*elem));
+        }
+    }
+    Destroy_All();
+    return result;
+}
+
+template <typename T, typename Allocator>
+typename ConcurrentVector<T, Allocator>::Segment& ConcurrentVector<T, Allocator>::Get_Segment(size_t segment_index) {
+    Segment* segment = segments_[segment_index].load(std::memory_order_acquire);
+    if (segment != nullptr) {
+        return *segment;
+    }
+    auto created = std::make_unique<Segment>(First_Segment() << segment_index, alloc_);
+    if (segments_[segment_index].compare_exchange_strong(segment, created.get(), std::memory_order_acq_rel,
+                                                         std::memory_order_acquire)) {
+        return *created.release();
+    }
+    // Сегмент успел установить другой поток, созданный освобождается
+    return *segment;
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+std::pair<size_t, T*> ConcurrentVector<T, Allocator>::Emplace_Slot(Args&&... args) {
+    const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+    const auto [segment_index, offset] = Locate(index);
+    Segment& segment = Get_Segment(segment_index);
+    T* elem = new (segment.data + offset) T(std::forward<Args>(args)...);
+    segment.published[offset].store(true, std::memory_order_release);
+    return {index, elem};
+}
+
+template <typename T, typename Allocator>
+void ConcurrentVector<T, Allocator>::Destroy_All() noexcept {
+    const size_t size = size_.exchange(0, std::memory_order_acq_rel);
+    for (size_t segment_index = 0; segment_index < MAX_SEGMENTS; ++segment_index) {
+        std::unique_ptr<Segment> segment(segments_[segment_index].exchange(nullptr, std::memory_order_acq_rel));
+        if (segment == nullptr) {
+            continue;
+        }
+        const size_t begin = ((size_t{1} << segment_index) - 1) << first_shift_;
+        const size_t end = std::min(size, begin + segment->data.Capacity());
+        for (size_t i = begin; i < end; ++i) {
+            if (segment->published[i - begin].load(std::memory_order_relaxed)) {
+                std::destroy_at(segment->data.GetAddress() + (i - begin));
+            }
+        }
+    }
+}
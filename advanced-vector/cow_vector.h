@@ -0,0 +1,400 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+
+// Вектор с копированием при записи. Копии CowVector разделяют один Vector с атомарным счётчиком ссылок,
+// поэтому копирование занимает O(1) и не выделяет память. Первый изменяющий вызов (неконстантные
+// operator[], begin/end, PushBack, Erase и т. д.) у копии, которая разделяет буфер с другими,
+// копирует элементы в собственный буфер («отсоединяется»). Адрес и размер буфера хранятся в самом
+// CowVector, поэтому чтение через константный объект не обращается к счётчику и не ветвится.
+// Как и std::shared_ptr, разные копии можно использовать из разных потоков, один объект — нет.
+// Неконстантный доступ отсоединяет вектор, поэтому для чтения из неконстантного объекта используйте
+// View, cbegin и cend
+template <typename T, typename Allocator = std::allocator<T>>
+class CowVector {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using Target = Vector<T, Allocator>;
+
+    CowVector() = default;
+    explicit CowVector(const Allocator& alloc);
+    explicit CowVector(size_t size, const Allocator& alloc = Allocator());
+    // Забирает буфер вектора без копирования
+    explicit CowVector(Target&& vector);
+    CowVector(const CowVector& other) noexcept;
+    CowVector(CowVector&& other) noexcept;
+
+    ~CowVector();
+
+    CowVector& operator=(const CowVector& rhs) noexcept;
+    CowVector& operator=(CowVector&& rhs) noexcept;
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T& operator[](size_t index) {
+        assert(index < size_);
+        return Mutable()[index];
+    }
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    // Представление элементов без отсоединения
+    ConstSpan<T> View() const noexcept {
+        return ConstSpan<T>(data_, size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_t Capacity() const noexcept;
+
+    // Число CowVector, разделяющих буфер; 0 у пустого вектора без буфера
+    size_t UseCount() const noexcept;
+
+    Allocator GetAllocator() const noexcept;
+
+    void Reserve(size_t new_capacity);
+    void Swap(CowVector& other) noexcept;
+    // Разделяемый буфер не копируется: вектор просто отпускает его
+    void Clear() noexcept;
+    void Resize(size_t new_size);
+    void PushBack(const T& value);
+    void PushBack(T&& value);
+    void PopBack();
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args);
+    iterator Insert(const_iterator pos, const T& value);
+    iterator Insert(const_iterator pos, T&& value);
+    iterator Erase(const_iterator pos);
+    iterator Erase(const_iterator first, const_iterator last);
+
+    // Копия элементов в отдельном Vector
+    Target ToVector() const;
+    // Переносит буфер в Vector без копирования, если он не разделяется, иначе копирует элементы;
+    // *this остаётся пустым
+    Target Take() &&;
+
+private:
+    struct Shared {
+        explicit Shared(Target&& vector) noexcept
+            : data(std::move(vector)) {
+        }
+
+        std::atomic<size_t> refs{1};
+        Target data;
+    };
+
+    Shared* shared_ = nullptr;
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    Allocator alloc_;
+
+    bool Is_Unique() const noexcept {
+        return shared_ != nullptr && shared_->refs.load(std::memory_order_acquire) == 1;
+    }
+
+    // Возвращает собственный вектор; при отсоединении вместимость копии не меньше min_capacity
+    Target& Mutable(size_t min_capacity = 0);
+    // Отсоединяет вектор, вызывает f(vector) и обновляет адрес и размер, в том числе при исключении
+    template <typename F>
+    decltype(auto) Modify(size_t min_capacity, F&& f);
+    void Sync() noexcept;
+    void Release() noexcept;
+};
+
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>::CowVector(const Allocator& alloc)
+    : alloc_(alloc) //
+{
+}
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>::CowVector(size_t size, const Allocator& alloc)
+    : CowVector(Target(size, alloc)) //
+{
+}
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>::CowVector(Target&& vector)
+    : alloc_(vector.GetAllocator()) //
+{
+    shared_ = new Shared(std::move(vector));
+    Sync();
+}
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>::CowVector(const CowVector& other) noexcept
+    : shared_(other.shared_)
+    , data_(other.data_)
+    , size_(other.size_)
+    , alloc_(other.alloc_) //
+{
+    if (shared_ != nullptr) {
+        shared_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>::CowVector(CowVector&& other) noexcept
+    : shared_(std::exchange(other.shared_, nullptr))
+    , data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , alloc_(other.alloc_) //
+{
+}
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>::~CowVector() {
+    Release();
+}
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>& CowVector<T, Allocator>::operator=(const CowVector& rhs) noexcept {
+    if (shared_ != rhs.shared_) {
+        CowVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator>
+CowVector<T, Allocator>& CowVector<T, Allocator>::operator=(CowVector&& rhs) noexcept {
+    Swap(rhs);
+    return *this;
+}
+
+//Итераторы
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::iterator CowVector<T, Allocator>::begin() {
+    return size_ == 0 ? data_ : Mutable().begin();
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::iterator CowVector<T, Allocator>::end() {
+    return begin() + size_;
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::const_iterator CowVector<T, Allocator>::begin() const noexcept {
+    return data_;
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::const_iterator CowVector<T, Allocator>::end() const noexcept {
+    return data_ + size_;
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::const_iterator CowVector<T, Allocator>::cbegin() const noexcept {
+    return begin();
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::const_iterator CowVector<T, Allocator>::cend() const noexcept {
+    return end();
+}
+
+template <typename T, typename Allocator>
+size_t CowVector<T, Allocator>::Capacity() const noexcept {
+    return shared_ != nullptr ? shared_->data.Capacity() : 0;
+}
+
+template <typename T, typename Allocator>
+size_t CowVector<T, Allocator>::UseCount() const noexcept {
+    return shared_ != nullptr ? shared_->refs.load(std::memory_order_acquire) : 0;
+}
+
+template <typename T, typename Allocator>
+Allocator CowVector<T, Allocator>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::Reserve(size_t new_capacity) {
+    if (new_capacity == 0 || (new_capacity <= Capacity() && Is_Unique())) {
+        return;
+    }
+    Modify(new_capacity, [new_capacity](Target& vector) {
+        vector.Reserve(new_capacity);
+    });
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::Swap(CowVector& other) noexcept {
+    using std::swap;
+    std::swap(shared_, other.shared_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    swap(alloc_, other.alloc_);
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::Clear() noexcept {
+    if (Is_Unique()) {
+        shared_->data.Clear();
+        Sync();
+        return;
+    }
+    Release();
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::Resize(size_t new_size) {
+    Modify(new_size, [new_size](Target& vector) {
+        vector.Resize(new_size);
+    });
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::PushBack(const T& value) {
+    EmplaceBack(value);
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::PushBack(T&& value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::PopBack() {
+    assert(size_ > 0);
+    Modify(0, [](Target& vector) {
+        vector.PopBack();
+    });
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+T& CowVector<T, Allocator>::EmplaceBack(Args&&... args) {
+    // Копия сразу получает место под новый элемент. args могут ссылаться на разделяемый буфер:
+    // его держит другой владелец, пока отсоединённая копия создаёт элемент
+    return Modify(size_ + 1, [&args...](Target& vector) -> T& {
+        return vector.EmplaceBack(std::forward<Args>(args)...);
+    });
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+typename CowVector<T, Allocator>::iterator CowVector<T, Allocator>::Emplace(const_iterator pos, Args&&... args) {
+    assert(pos >= cbegin() && pos <= cend());
+    // Отсоединение меняет буфер, поэтому позиция пересчитывается по индексу
+    const size_t index = static_cast<size_t>(pos - cbegin());
+    return Modify(size_ + 1, [index, &args...](Target& vector) {
+        return vector.Emplace(vector.cbegin() + index, std::forward<Args>(args)...);
+    });
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::iterator CowVector<T, Allocator>::Insert(const_iterator pos, const T& value) {
+    return Emplace(pos, value);
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::iterator CowVector<T, Allocator>::Insert(const_iterator pos, T&& value) {
+    return Emplace(pos, std::move(value));
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::iterator CowVector<T, Allocator>::Erase(const_iterator pos) {
+    assert(pos >= cbegin() && pos < cend());
+    return Erase(pos, pos + 1);
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::iterator CowVector<T, Allocator>::Erase(const_iterator first, const_iterator last) {
+    assert(first >= cbegin() && first <= last && last <= cend());
+    const size_t first_index = static_cast<size_t>(first - cbegin());
+    const size_t last_index = static_cast<size_t>(last - cbegin());
+    if (first_index == last_index) {
+        return size_ == 0 ? data_ : Mutable().begin() + first_index;
+    }
+    return Modify(0, [first_index, last_index](Target& vector) {
+        return vector.Erase(vector.cbegin() + first_index, vector.cbegin() + last_index);
+    });
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::Target CowVector<T, Allocator>::ToVector() const {
+    Target result(alloc_);
+    result.Append(View());
+    return result;
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::Target CowVector<T, Allocator>::Take() && {
+    Target result = Is_Unique() ? std::move(shared_->data) : ToVector();
+    Release();
+    return result;
+}
+
+template <typename T, typename Allocator>
+typename CowVector<T, Allocator>::Target& CowVector<T, Allocator>::Mutable(size_t min_capacity) {
+    if (Is_Unique()) {
+        return shared_->data;
+    }
+    Target copy(alloc_);
+    copy.Reserve(std::max(min_capacity, size_));
+    copy.Append(View());
+    // Shared создаётся до отпускания старого буфера: при нехватке памяти вектор не меняется
+    Shared* detached = new Shared(std::move(copy));
+    Release();
+    shared_ = detached;
+    Sync();
+    return shared_->data;
+}
+
+template <typename T, typename Allocator>
+template <typename F>
+decltype(auto) CowVector<T, Allocator>::Modify(size_t min_capacity, F&& f) {
+    Target& vector = Mutable(min_capacity);
+    try {
+        if constexpr (std::is_void_v<decltype(f(vector))>) {
+            f(vector);
+            Sync();
+        } else {
+            decltype(auto) result = f(vector);
+            Sync();
+            return result;
+        }
+    } catch (...) {
+        Sync();
+        throw;
+    }
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::Sync() noexcept {
+    data_ = shared_->data.begin();
+    size_ = shared_->data.Size();
+}
+
+template <typename T, typename Allocator>
+void CowVector<T, Allocator>::Release() noexcept {
+    Shared* shared = std::exchange(shared_, nullptr);
+    data_ = nullptr;
+    size_ = 0;
+    if (shared != nullptr && shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete shared;
+    }
+}
@@ -0,0 +1,592 @@
+#pragma once
+#include "vector.h"
+
+#include <numeric>
+
+namespace detail {
+
+// Индекс первого элемента отсортированного массива, не меньшего key. Цикл всегда делает около
+// log2(size) сравнений, и выбор половины компилируется в условную пересылку без ветвления,
+// поэтому промахи предсказателя переходов не зависят от искомых ключей
+template <typename T, typename Compare>
+size_t Branchless_Lower_Bound(const T* data, size_t size, const T& key, const Compare& comp) {
+    if (size == 0) {
+        return 0;
+    }
+    const T* base = data;
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = comp(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<size_t>(base - data) + (comp(*base, key) ? 1 : 0);
+}
+
+inline size_t Count_Trailing_Ones(size_t value) noexcept {
+#if defined(__GNUC__)
+    return ~value == 0 ? sizeof(size_t) * 8 : static_cast<size_t>(__builtin_ctzll(~value));
+#else
+    size_t result = 0;
+    while (value & 1) {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+// Копия отсортированных ключей в порядке Эйтцингера: узел k неявного дерева поиска хранится в keys_[k - 1],
+// его потомки — узлы 2k и 2k + 1. Первые уровни дерева, которые проходит каждый поиск, лежат рядом
+// в начале массива и остаются в кэше, а шаг поиска k = 2k + (key > узла) не ветвится
+template <typename Key>
+class EytzingerLayout {
+public:
+    // sorted должен быть упорядочен тем же сравнением, что передаётся в LowerBound
+    void Build(ConstSpan<Key> sorted);
+    void Clear() noexcept;
+
+    // Позиция первого ключа, не меньшего key, в исходном отсортированном порядке
+    template <typename Compare>
+    size_t LowerBound(const Key& key, const Compare& comp) const;
+
+private:
+    Vector<Key> keys_;
+    // Позиция узла в отсортированном порядке
+    Vector<size_t> ranks_;
+
+    // Нумерует узлы поддерева node в порядке обхода слева направо, начиная с next
+    static size_t Fill_Ranks(size_t node, size_t next, Vector<size_t>& ranks) noexcept;
+};
+
+template <typename Key>
+void EytzingerLayout<Key>::Build(ConstSpan<Key> sorted) {
+    Vector<size_t> ranks(sorted.Size());
+    Fill_Ranks(1, 0, ranks);
+    Vector<Key> keys;
+    keys.Reserve(sorted.Size());
+    for (const size_t rank : ranks) {
+        keys.EmplaceBack(sorted[rank]);
+    }
+    keys_.Swap(keys);
+    ranks_.Swap(ranks);
+}
+
+template <typename Key>
+void EytzingerLayout<Key>::Clear() noexcept {
+    keys_.Clear();
+    ranks_.Clear();
+}
+
+template <typename Key>
+template <typename Compare>
+size_t EytzingerLayout<Key>::LowerBound(const Key& key, const Compare& comp) const {
+    const size_t size = keys_.Size();
+    size_t node = 1;
+    while (node <= size) {
+        node = 2 * node + (comp(keys_[node - 1], key) ? 1 : 0);
+    }
+    // Последний поворот налево указывает на ответ: отбросить повороты направо после него
+    node >>= Count_Trailing_Ones(node) + 1;
+    return node == 0 ? size : ranks_[node - 1];
+}
+
+template <typename Key>
+size_t EytzingerLayout<Key>::Fill_Ranks(size_t node, size_t next, Vector<size_t>& ranks) noexcept {
+    if (node > ranks.Size()) {
+        return next;
+    }
+    next = Fill_Ranks(2 * node, next, ranks);
+    ranks[node - 1] = next++;
+    return Fill_Ranks(2 * node + 1, next, ranks);
+}
+
+// Переносит в merged элементы по плану слияния: номер source < existing.Size() берётся из existing,
+// остальные — из added[source - existing.Size()]. Память merged выделена заранее. Если MoveExisting,
+// элементы existing перемещаются, иначе копируются и остаются нетронутыми при исключении
+template <bool MoveExisting, typename T>
+void Merge_Column(Vector<T>& merged, Vector<T>& existing, Vector<T>& added, ConstSpan<size_t> plan) {
+    assert(merged.Capacity() >= plan.Size());
+    for (const size_t source : plan) {
+        if (source >= existing.Size()) {
+            merged.EmplaceBack(std::move(added[source - existing.Size()]));
+        } else if constexpr (MoveExisting) {
+            merged.EmplaceBack(std::move(existing[source]));
+        } else {
+            merged.EmplaceBack(existing[source]);
+        }
+    }
+}
+
+}  // namespace detail
+
+template <typename Key, typename Value, typename Compare>
+class FlatMap;
+
+// Множество уникальных ключей, хранящихся по возрастанию в одном Vector. Поиск — lower_bound без
+// ветвлений по непрерывному массиву вместо прохода по узлам std::set. InsertRange добавляет пакет ключей
+// за одну сортировку и одно слияние вместо сдвига хвоста на каждый ключ. Для таблиц, которые после
+// заполнения только читаются, BuildIndex строит копию ключей в порядке Эйтцингера; пока копия есть,
+// поиск идёт по ней, а любое изменение ключей её удаляет. Индекс ускоряет поиск, пока таблица умещается
+// в кэш; на таблицах больше кэша его обгоняет обычный поиск, которому не нужен второй массив позиций
+template <typename Key, typename Compare = std::less<Key>>
+class FlatSet {
+public:
+    using value_type = Key;
+    using key_compare = Compare;
+    using const_iterator = const Key*;
+
+    FlatSet() = default;
+    explicit FlatSet(const Compare& comp);
+    template <typename InputIt>
+    FlatSet(InputIt first, InputIt last, const Compare& comp = Compare());
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+    const Key& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return keys_[index];
+    }
+
+    ConstSpan<Key> Keys() const noexcept {
+        return ConstSpan<Key>(keys_.begin(), keys_.Size());
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return keys_.Size() == 0;
+    }
+
+    // Позиция первого ключа, не меньшего key
+    size_t LowerBound(const Key& key) const;
+    // Ключ, равный key, или nullptr
+    const Key* Find(const Key& key) const;
+    bool Contains(const Key& key) const;
+
+    // Возвращает позицию ключа и признак того, что он добавлен
+    std::pair<size_t, bool> Insert(Key key);
+    // Добавляет ключи [first, last); из равных ключей остаётся уже имевшийся или первый из диапазона
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last);
+
+    bool Erase(const Key& key);
+    void EraseAt(size_t index);
+
+    void Reserve(size_t new_capacity);
+    void Clear() noexcept;
+    void Swap(FlatSet& other) noexcept;
+
+    void BuildIndex();
+
+    bool HasIndex() const noexcept {
+        return has_index_;
+    }
+
+private:
+    template <typename, typename, typename>
+    friend class FlatMap;
+
+    Vector<Key> keys_;
+    detail::EytzingerLayout<Key> index_;
+    bool has_index_ = false;
+    Compare comp_;
+
+    // Позиция ключа, равного key, или Size()
+    size_t Index_Of(const Key& key) const;
+    void Insert_At(size_t index, Key&& key);
+    void Drop_Index() noexcept;
+    // План слияния ключей с added для detail::Merge_Column: added сортируется устойчиво, ключи, равные
+    // имеющимся или предыдущим из added, пропускаются
+    Vector<size_t> Merge_Plan(const Vector<Key>& added) const;
+    void Assign(Vector<Key>& merged) noexcept;
+};
+
+// Отображение с ключами в FlatSet и значениями в отдельном столбце Vector<Value> той же длины: поиск
+// проходит только по ключам, а значение берётся по найденной позиции. Интерфейс построен на позициях:
+// KeyAt(i) и ValueAt(i) — i-я пара в порядке возрастания ключей.
+// Значения должны перемещаться присваиванием без исключений, иначе сбой при сдвиге столбца значений
+// оставил бы его длину отличной от длины столбца ключей
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class FlatMap {
+    static_assert(std::is_nothrow_move_assignable_v<Value>, "values are shifted after the keys");
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using key_compare = Compare;
+
+    FlatMap() = default;
+    explicit FlatMap(const Compare& comp);
+    // Принимает диапазон пар ключ-значение
+    template <typename InputIt>
+    FlatMap(InputIt first, InputIt last, const Compare& comp = Compare());
+
+    size_t Size() const noexcept {
+        return values_.Size();
+    }
+
+    bool Empty() const noexcept {
+        return values_.Size() == 0;
+    }
+
+    ConstSpan<Key> Keys() const noexcept {
+        return keys_.Keys();
+    }
+
+    Span<Value> Values() noexcept {
+        return Span<Value>(values_.begin(), values_.Size());
+    }
+
+    ConstSpan<Value> Values() const noexcept {
+        return ConstSpan<Value>(values_.begin(), values_.Size());
+    }
+
+    const Key& KeyAt(size_t index) const noexcept {
+        return keys_[index];
+    }
+
+    Value& ValueAt(size_t index) noexcept {
+        assert(index < Size());
+        return values_[index];
+    }
+
+    const Value& ValueAt(size_t index) const noexcept {
+        assert(index < Size());
+        return values_[index];
+    }
+
+    size_t LowerBound(const Key& key) const;
+    // Значение для key или nullptr
+    Value* Find(const Key& key);
+    const Value* Find(const Key& key) const;
+    bool Contains(const Key& key) const;
+
+    // Значение для key; если ключа нет, добавляет значение по умолчанию
+    Value& operator[](const Key& key);
+
+    // Если ключа нет, добавляет значение из args. Возвращает позицию пары и признак того, что она добавлена
+    template <typename... Args>
+    std::pair<size_t, bool> TryEmplace(Key key, Args&&... args);
+    std::pair<size_t, bool> Insert(Key key, Value value);
+    // Добавляет пары [first, last); из равных ключей остаётся уже имевшийся или первый из диапазона
+    template <typename InputIt>
+    void InsertRange(InputIt first, InputIt last);
+
+    bool Erase(const Key& key);
+    void EraseAt(size_t index);
+
+    void Reserve(size_t new_capacity);
+    void Clear() noexcept;
+    void Swap(FlatMap& other) noexcept;
+
+    // Строит индекс Эйтцингера по ключам; изменение значений его не удаляет
+    void BuildIndex();
+
+    bool HasIndex() const noexcept {
+        return keys_.HasIndex();
+    }
+
+private:
+    FlatSet<Key, Compare> keys_;
+    Vector<Value> values_;
+};
+
+
+template <typename Key, typename Compare>
+FlatSet<Key, Compare>::FlatSet(const Compare& comp)
+    : comp_(comp) //
+{
+}
+
+template <typename Key, typename Compare>
+template <typename InputIt>
+FlatSet<Key, Compare>::FlatSet(InputIt first, InputIt last, const Compare& comp)
+    : comp_(comp) //
+{
+    InsertRange(first, last);
+}
+
+//Итераторы
+template <typename Key, typename Compare>
+typename FlatSet<Key, Compare>::const_iterator FlatSet<Key, Compare>::begin() const noexcept {
+    return keys_.begin();
+}
+
+template <typename Key, typename Compare>
+typename FlatSet<Key, Compare>::const_iterator FlatSet<Key, Compare>::end() const noexcept {
+    return keys_.end();
+}
+
+template <typename Key, typename Compare>
+size_t FlatSet<Key, Compare>::LowerBound(const Key& key) const {
+    if (has_index_) {
+        return index_.LowerBound(key, comp_);
+    }
+    return detail::Branchless_Lower_Bound(keys_.begin(), keys_.Size(), key, comp_);
+}
+
+template <typename Key, typename Compare>
+const Key* FlatSet<Key, Compare>::Find(const Key& key) const {
+    const size_t index = Index_Of(key);
+    return index == Size() ? nullptr : keys_.begin() + index;
+}
+
+template <typename Key, typename Compare>
+bool FlatSet<Key, Compare>::Contains(const Key& key) const {
+    return Index_Of(key) != Size();
+}
+
+template <typename Key, typename Compare>
+std::pair<size_t, bool> FlatSet<Key, Compare>::Insert(Key key) {
+    const size_t index = LowerBound(key);
+    if (index != Size() && !comp_(key, keys_[index])) {
+        return {index, false};
+    }
+    Insert_At(index, std::move(key));
+    return {index, true};
+}
+
+template <typename Key, typename Compare>
+template <typename InputIt>
+void FlatSet<Key, Compare>::InsertRange(InputIt first, InputIt last) {
+    Vector<Key> added;
+    added.Append(first, last);
+    const Vector<size_t> plan = Merge_Plan(added);
+    Vector<Key> merged;
+    merged.Reserve(plan.Size());
+    detail::Merge_Column<std::is_nothrow_move_constructible_v<Key>>(merged, keys_, added, plan);
+    Assign(merged);
+}
+
+template <typename Key, typename Compare>
+bool FlatSet<Key, Compare>::Erase(const Key& key) {
+    const size_t index = Index_Of(key);
+    if (index == Size()) {
+        return false;
+    }
+    EraseAt(index);
+    return true;
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::EraseAt(size_t index) {
+    assert(index < Size());
+    Drop_Index();
+    keys_.Erase(keys_.cbegin() + index);
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::Reserve(size_t new_capacity) {
+    keys_.Reserve(new_capacity);
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::Clear() noexcept {
+    Drop_Index();
+    keys_.Clear();
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::Swap(FlatSet& other) noexcept {
+    using std::swap;
+    keys_.Swap(other.keys_);
+    swap(index_, other.index_);
+    std::swap(has_index_, other.has_index_);
+    swap(comp_, other.comp_);
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::BuildIndex() {
+    index_.Build(Keys());
+    has_index_ = true;
+}
+
+template <typename Key, typename Compare>
+size_t FlatSet<Key, Compare>::Index_Of(const Key& key) const {
+    const size_t index = LowerBound(key);
+    return index != Size() && !comp_(key, keys_[index]) ? index : Size();
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::Insert_At(size_t index, Key&& key) {
+    Drop_Index();
+    keys_.Insert(keys_.cbegin() + index, std::move(key));
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::Drop_Index() noexcept {
+    if (has_index_) {
+        index_.Clear();
+        has_index_ = false;
+    }
+}
+
+template <typename Key, typename Compare>
+Vector<size_t> FlatSet<Key, Compare>::Merge_Plan(const Vector<Key>& added) const {
+    Vector<size_t> order(added.Size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [this, &added](size_t lhs, size_t rhs) {
+        return comp_(added[lhs], added[rhs]);
+    });
+
+    const size_t size = Size();
+    Vector<size_t> plan;
+    plan.Reserve(size + added.Size());
+    size_t existing = 0;
+    const Key* last_added = nullptr;
+    for (const size_t source : order) {
+        const Key& key = added[source];
+        while (existing < size && comp_(keys_[existing], key)) {
+            plan.PushBack(existing++);
+        }
+        if (existing < size && !comp_(key, keys_[existing])) {
+            continue;
+        }
+        // Ключи из added упорядочены, поэтому равный ключ может быть только последним взятым из added
+        if (last_added != nullptr && !comp_(*last_added, key)) {
+            continue;
+        }
+        plan.PushBack(size + source);
+        last_added = &key;
+    }
+    while (existing < size) {
+        plan.PushBack(existing++);
+    }
+    return plan;
+}
+
+template <typename Key, typename Compare>
+void FlatSet<Key, Compare>::Assign(Vector<Key>& merged) noexcept {
+    Drop_Index();
+    keys_.Swap(merged);
+}
+
+template <typename Key, typename Value, typename Compare>
+FlatMap<Key, Value, Compare>::FlatMap(const Compare& comp)
+    : keys_(comp) //
+{
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename InputIt>
+FlatMap<Key, Value, Compare>::FlatMap(InputIt first, InputIt last, const Compare& comp)
+    : keys_(comp) //
+{
+    InsertRange(first, last);
+}
+
+template <typename Key, typename Value, typename Compare>
+size_t FlatMap<Key, Value, Compare>::LowerBound(const Key& key) const {
+    return keys_.LowerBound(key);
+}
+
+template <typename Key, typename Value, typename Compare>
+Value* FlatMap<Key, Value, Compare>::Find(const Key& key) {
+    const size_t index = keys_.Index_Of(key);
+    return index == Size() ? nullptr : values_.begin() + index;
+}
+
+template <typename Key, typename Value, typename Compare>
+const Value* FlatMap<Key, Value, Compare>::Find(const Key& key) const {
+    return const_cast<FlatMap&>(*this).Find(key);
+}
+
+template <typename Key, typename Value, typename Compare>
+bool FlatMap<Key, Value, Compare>::Contains(const Key& key) const {
+    return keys_.Contains(key);
+}
+
+template <typename Key, typename Value, typename Compare>
+Value& FlatMap<Key, Value, Compare>::operator[](const Key& key) {
+    return values_[TryEmplace(key).first];
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename... Args>
+std::pair<size_t, bool> FlatMap<Key, Value, Compare>::TryEmplace(Key key, Args&&... args) {
+    const size_t index = keys_.LowerBound(key);
+    if (index != Size() && !keys_.comp_(key, keys_[index])) {
+        return {index, false};
+    }
+    // Значение вставляется первым: args могут ссылаться на значения, которые сдвинет вставка
+    values_.Emplace(values_.cbegin() + index, std::forward<Args>(args)...);
+    try {
+        keys_.Insert_At(index, std::move(key));
+    } catch (...) {
+        values_.Erase(values_.cbegin() + index);
+        throw;
+    }
+    return {index, true};
+}
+
+template <typename Key, typename Value, typename Compare>
+std::pair<size_t, bool> FlatMap<Key, Value, Compare>::Insert(Key key, Value value) {
+    return TryEmplace(std::move(key), std::move(value));
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename InputIt>
+void FlatMap<Key, Value, Compare>::InsertRange(InputIt first, InputIt last) {
+    Vector<Key> added_keys;
+    Vector<Value> added_values;
+    for (; first != last; ++first) {
+        added_keys.EmplaceBack(first->first);
+        added_values.EmplaceBack(first->second);
+    }
+    const Vector<size_t> plan = keys_.Merge_Plan(added_keys);
+    // Оба столбца выделяются до переноса: после перемещения первых ключей ничто не выбрасывает исключений
+    Vector<Key> merged_keys;
+    merged_keys.Reserve(plan.Size());
+    Vector<Value> merged_values;
+    merged_values.Reserve(plan.Size());
+    constexpr bool MOVE_EXISTING = std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<Value>;
+    detail::Merge_Column<MOVE_EXISTING>(merged_keys, keys_.keys_, added_keys, plan);
+    detail::Merge_Column<MOVE_EXISTING>(merged_values, values_, added_values, plan);
+    keys_.Assign(merged_keys);
+    values_.Swap(merged_values);
+}
+
+template <typename Key, typename Value, typename Compare>
+bool FlatMap<Key, Value, Compare>::Erase(const Key& key) {
+    const size_t index = keys_.Index_Of(key);
+    if (index == Size()) {
+        return false;
+    }
+    EraseAt(index);
+    return true;
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::EraseAt(size_t index) {
+    assert(index < Size());
+    // Если сдвиг ключей выбросит исключение, значения ещё не тронуты; сдвиг значений не выбрасывает
+    keys_.EraseAt(index);
+    values_.Erase(values_.cbegin() + index);
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::Reserve(size_t new_capacity) {
+    keys_.Reserve(new_capacity);
+    values_.Reserve(new_capacity);
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::Clear() noexcept {
+    keys_.Clear();
+    values_.Clear();
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::Swap(FlatMap& other) noexcept {
+    keys_.Swap(other.keys_);
+    values_.Swap(other.values_);
+}
+
+template <typename Key, typename Value, typename Compare>
+void FlatMap<Key, Value, Compare>::BuildIndex() {
+    keys_.BuildIndex();
+}
@@ -0,0 +1,311 @@
+#pragma once
+#include "vector.h"
+
+// Вектор с постепенным перевыделением. При росте выделяется новый буфер, и в него сразу попадает только
+// добавляемый элемент; старые элементы переносятся по MigrationStep за каждое следующее добавление.
+// Пока перенос не закончен, operator[] выбирает буфер по индексу. Ни одно добавление не переносит
+// больше MigrationStep элементов, поэтому его время не зависит от размера. Если GrowthPolicy увеличивает
+// вместимость хотя бы в 1 + 1 / MigrationStep раза, перенос заканчивается раньше следующего роста,
+// иначе рост сначала завершает его (FinishMigration).
+// Элементы переносятся после добавления, поэтому перемещающий конструктор T не должен выбрасывать
+// исключений. Ссылка, возвращённая EmplaceBack, действительна до конца переноса
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth, size_t MigrationStep = 4>
+class IncrementalVector {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "elements are migrated after a successful append");
+    static_assert(MigrationStep > 0, "migration must make progress");
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using iterator = detail::IndexIterator<IncrementalVector, false>;
+    using const_iterator = detail::IndexIterator<IncrementalVector, true>;
+
+    IncrementalVector() = default;
+    explicit IncrementalVector(const Allocator& alloc) noexcept;
+    explicit IncrementalVector(size_t size, const Allocator& alloc = Allocator());
+    IncrementalVector(const IncrementalVector& other);
+    IncrementalVector(IncrementalVector&& other) noexcept;
+
+    ~IncrementalVector();
+
+    IncrementalVector& operator=(const IncrementalVector& rhs);
+    IncrementalVector& operator=(IncrementalVector&& rhs) noexcept;
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<IncrementalVector&>(*this)[index];
+    }
+
+    // Ещё не перенесённые элементы [migrated_, old_size_) остаются в старом буфере
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        if (index < old_size_ && index >= migrated_) {
+            return old_data_[index];
+        }
+        return data_[index];
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Часть элементов ещё находится в старом буфере
+    bool IsMigrating() const noexcept {
+        return old_data_.GetAddress() != nullptr;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    // Переносит оставшиеся элементы в новый буфер и освобождает старый. После вызова элементы лежат
+    // одним массивом с начала буфера
+    void FinishMigration() noexcept;
+    // Явное резервирование переносит все элементы сразу, как Vector::Reserve
+    void Reserve(size_t new_capacity);
+    void Swap(IncrementalVector& other) noexcept;
+    void Resize(size_t new_size);
+    void PushBack(const T& value);
+    void PushBack(T&& value);
+    void PopBack() noexcept;
+    void Clear() noexcept;
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+private:
+    RawMemory<T, Allocator> data_;
+    // Буфер до последнего роста; пуст, когда перенос закончен
+    RawMemory<T, Allocator> old_data_;
+    size_t size_ = 0;
+    // Число элементов в буфере до роста и число уже перенесённых из них
+    size_t old_size_ = 0;
+    size_t migrated_ = 0;
+
+    void Migrate(size_t count) noexcept;
+    void Destroy_All() noexcept;
+};
+
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IncrementalVector(const Allocator& alloc) noexcept
+    : data_(alloc)
+    , old_data_(alloc) //
+{
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IncrementalVector(size_t size, const Allocator& alloc)
+    : data_(size, alloc)
+    , old_data_(alloc) //
+{
+    std::uninitialized_value_construct_n(data_.GetAddress(), size);
+    size_ = size;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IncrementalVector(const IncrementalVector& other)
+    : data_(other.size_, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator()))
+    , old_data_(data_.GetAllocator()) //
+{
+    // Копия собирается одним массивом, даже если в other идёт перенос
+    size_t i = 0;
+    try {
+        for (; i < other.size_; ++i) {
+            new (data_ + i) T(other[i]);
+        }
+    } catch (...) {
+        std::destroy_n(data_.GetAddress(), i);
+        throw;
+    }
+    size_ = other.size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IncrementalVector(IncrementalVector&& other) noexcept
+    : data_(std::move(other.data_))
+    , old_data_(std::move(other.old_data_))
+    , size_(std::exchange(other.size_, 0))
+    , old_size_(std::exchange(other.old_size_, 0))
+    , migrated_(std::exchange(other.migrated_, 0)) //
+{
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::~IncrementalVector() {
+    Destroy_All();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>& IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::operator=(const IncrementalVector& rhs) {
+    if (this != &rhs) {
+        /* Применить copy-and-swap */
+        IncrementalVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>& IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::operator=(IncrementalVector&& rhs) noexcept {
+    Swap(rhs);
+    return *this;
+}
+
+//Итераторы
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::iterator IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::begin() noexcept {
+    return iterator(this, 0);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::iterator IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::const_iterator IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::const_iterator IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::end() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::const_iterator IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::cbegin() const noexcept {
+    return begin();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::const_iterator IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::cend() const noexcept {
+    return end();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::FinishMigration() noexcept {
+    Migrate(old_size_ - migrated_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Reserve(size_t new_capacity) {
+    FinishMigration();
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+    detail::Relocate_N(data_.GetAddress(), size_, new_data.GetAddress());
+    data_.Swap(new_data);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Swap(IncrementalVector& other) noexcept {
+    data_.Swap(other.data_);
+    old_data_.Swap(other.old_data_);
+    std::swap(size_, other.size_);
+    std::swap(old_size_, other.old_size_);
+    std::swap(migrated_, other.migrated_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Resize(size_t new_size) {
+    if (new_size < size_) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        return;
+    }
+    while (size_ < new_size) {
+        EmplaceBack();
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::PushBack(const T& value) {
+    EmplaceBack(value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::PushBack(T&& value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::PopBack() noexcept {
+    assert(size_ > 0);
+    std::destroy_at(&(*this)[size_ - 1]);
+    --size_;
+    if (old_size_ > size_) {
+        // Удалён ещё не перенесённый элемент
+        old_size_ = size_;
+        Migrate(0);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Clear() noexcept {
+    Destroy_All();
+    size_ = 0;
+    old_size_ = 0;
+    migrated_ = 0;
+    RawMemory<T, Allocator>(data_.GetAllocator()).Swap(old_data_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+template <typename... Args>
+T& IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::EmplaceBack(Args&&... args) {
+    T* elem = nullptr;
+    if (size_ == Capacity()) {
+        FinishMigration();
+        RawMemory<T, Allocator> new_data(GrowthPolicy::NextCapacity(Capacity(), size_ + 1, sizeof(T)), data_.GetAllocator());
+        // args могут ссылаться на элементы, поэтому буферы меняются местами только после создания
+        elem = new (new_data + size_) T(std::forward<Args>(args)...);
+        old_data_.Swap(data_);
+        data_.Swap(new_data);
+        old_size_ = size_;
+        migrated_ = 0;
+        ++size_;
+        // Первая порция переносится уже сейчас: пустой старый буфер освобождается сразу
+        Migrate(MigrationStep);
+    } else {
+        elem = new (data_ + size_) T(std::forward<Args>(args)...);
+        ++size_;
+        Migrate(MigrationStep);
+    }
+    return *elem;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Migrate(size_t count) noexcept {
+    if (!IsMigrating()) {
+        return;
+    }
+    count = std::min(count, old_size_ - migrated_);
+    detail::Relocate_N(old_data_ + migrated_, count, data_ + migrated_);
+    migrated_ += count;
+    if (migrated_ == old_size_) {
+        RawMemory<T, Allocator>(data_.GetAllocator()).Swap(old_data_);
+        old_size_ = 0;
+        migrated_ = 0;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Destroy_All() noexcept {
+    std::destroy_n(data_.GetAddress(), IsMigrating() ? migrated_ : size_);
+    if (IsMigrating()) {
+        std::destroy_n(old_data_ + migrated_, old_size_ - migrated_);
+        std::destroy_n(data_ + old_size_, size_ - old_size_);
+    }
+}
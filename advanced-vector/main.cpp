@@ -1,8 +1,34 @@
 #include "vector.h"
+#include "small_vector.h"
+#include "simd.h"
+#include "mmap_allocator.h"
+#include "mapped_vector.h"
+#include "serialize.h"
+#include "segmented_vector.h"
+#include "incremental_vector.h"
+#include "concurrent_vector.h"
+#include "batch_appender.h"
+#include "soa_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "static_vector.h"
+#include "vector_pool.h"
 
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <memory_resource>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -116,8 +142,93 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Аллокатор с состоянием: считает выделения в общем на все копии счётчике
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    struct Counters {
+        int allocations = 0;
+        int deallocations = 0;
+    };
+
+    explicit CountingAllocator(Counters* counters) noexcept
+        : counters(counters) {
+    }
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept
+        : counters(other.counters) {
+    }
+
+    T* allocate(size_t n) {
+        ++counters->allocations;
+        return static_cast<T*>(operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        ++counters->deallocations;
+        operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept {
+        return counters == other.counters;
+    }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& other) const noexcept {
+        return counters != other.counters;
+    }
+
+    Counters* counters;
+};
+
+// Владеющий дескриптор: перемещается нетривиально, но допускает перенос побайтовым копированием
+struct Handle {
+    Handle() = default;
+    explicit Handle(int value)
+        : value(std::make_unique<int>(value)) {
+    }
+    Handle(const Handle& other)
+        : value(other.value ? std::make_unique<int>(*other.value) : nullptr) {
+        ++num_copied;
+    }
+    Handle(Handle&& other) noexcept
+        : value(std::move(other.value)) {
+        ++num_moved;
+    }
+    Handle& operator=(const Handle& other) {
+        value = other.value ? std::make_unique<int>(*other.value) : nullptr;
+        return *this;
+    }
+    Handle& operator=(Handle&& other) noexcept {
+        value = std::move(other.value);
+        ++num_moved;
+        return *this;
+    }
+    ~Handle() {
+        ++num_destroyed;
+    }
+
+    static void ResetCounters() {
+        num_copied = 0;
+        num_moved = 0;
+        num_destroyed = 0;
+    }
+
+    std::unique_ptr<int> value;
+
+    static inline int num_copied = 0;
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
 }  // namespace
 
+template <>
+struct is_trivially_relocatable<Handle> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -537,9 +648,20 @@ void Test6() {
         assert(Obj::num_copied == 0);
         assert(Obj::num_default_constructed == SIZE);
         assert(Obj::num_constructed_with_id_and_name == 1);
-        assert(Obj::num_moved == old_num_moved + 1);
-        assert(Obj::num_move_assigned == SIZE - 3);
+        // Хвост переносится перемещающим конструктором, а элемент создаётся на своём месте без временного
+        assert(Obj::num_moved == old_num_moved + static_cast<int>(SIZE - 3));
+        assert(Obj::num_move_assigned == 0);
         assert(Obj::num_assigned == 0);
+        assert(Obj::GetAliveObjectCount() == SIZE + 1);
+    }
+    {
+        // Вставка в конец при свободной вместимости не трогает последний элемент
+        Vector<std::string> v;
+        v.Reserve(4);
+        v.PushBack("a"s);
+        v.PushBack("b"s);
+        v.Insert(v.end(), "c"s);
+        assert(v.Size() == 3 && v[0] == "a" && v[1] == "b" && v[2] == "c");
     }
     {
         Obj::ResetCounters();
@@ -558,6 +680,2127 @@ void Test6() {
     }
 }
 
+void Test7() {
+    const size_t SIZE = 10;
+    using Alloc = CountingAllocator<Obj>;
+    {
+        Obj::ResetCounters();
+        Alloc::Counters counters;
+        {
+            Vector<Obj, Alloc> v{Alloc(&counters)};
+            for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+                v.EmplaceBack(i);
+            }
+            v.Insert(v.cbegin() + 1, Obj{42});
+            v.Erase(v.cbegin());
+            assert(v.Size() == SIZE);
+            assert(v[0].id == 42);
+            assert(v.GetAllocator() == Alloc(&counters));
+            assert(counters.allocations > 0);
+        }
+        assert(counters.allocations == counters.deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Копирующее присваивание не распространяет аллокатор, перемещающее — распространяет
+        Alloc::Counters counters_a;
+        Alloc::Counters counters_b;
+        {
+            Vector<Obj, Alloc> a(SIZE, Alloc(&counters_a));
+            Vector<Obj, Alloc> b(SIZE * 2, Alloc(&counters_b));
+            a = b;
+            assert(a.Size() == SIZE * 2);
+            assert(a.GetAllocator() == Alloc(&counters_a));
+            Vector<Obj, Alloc> c{Alloc(&counters_a)};
+            c = std::move(b);
+            assert(c.Size() == SIZE * 2);
+            assert(c.GetAllocator() == Alloc(&counters_b));
+            a.Swap(c);
+            assert(a.GetAllocator() == Alloc(&counters_b));
+            assert(c.GetAllocator() == Alloc(&counters_a));
+        }
+        assert(counters_a.allocations == counters_a.deallocations);
+        assert(counters_b.allocations == counters_b.deallocations);
+    }
+    {
+        // Все выделения идут из арены; освобождение арены — один сброс
+        char buffer[4096];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        pmr::Vector<int> v{std::pmr::polymorphic_allocator<int>(&arena)};
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == 100);
+        assert(v[99] == 99);
+        const pmr::Vector<int> v_copy(v, std::pmr::polymorphic_allocator<int>(&arena));
+        assert(v_copy[50] == 50);
+        pmr::Vector<int> v_moved(std::move(v));
+        assert(v_moved.GetAllocator().resource() == &arena);
+        // Перемещающее присваивание между разными ресурсами копирует элементы в память приёмника
+        pmr::Vector<int> v_default;
+        v_default = std::move(v_moved);
+        assert(v_default.Size() == 100);
+        assert(v_default.GetAllocator().resource() == std::pmr::get_default_resource());
+    }
+}
+
+void Test8() {
+    const int SIZE = 100;
+    {
+        Handle::ResetCounters();
+        Vector<Handle> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Reserve(SIZE * 4);
+        // Перенос при росте и Reserve выполняется memcpy без перемещений и деструкторов
+        assert(Handle::num_moved == 0);
+        assert(Handle::num_destroyed == 0);
+
+        v.Insert(v.cbegin(), Handle{-1});
+        v.Emplace(v.cbegin() + SIZE / 2, -2);
+        v.Insert(v.cbegin() + 1, v[SIZE]);
+        assert(v.Size() == SIZE + 3);
+        assert(*v[0].value == -1);
+        assert(*v[1].value == SIZE - 2);
+        assert(*v[2].value == 0);
+        assert(*v[SIZE / 2 + 1].value == -2);
+        assert(*v[SIZE + 2].value == SIZE - 1);
+        // Только перемещение временного объекта Handle{-1} в новый элемент
+        assert(Handle::num_moved == 1);
+        assert(Handle::num_copied == 1);
+
+        Handle::ResetCounters();
+        v.Erase(v.cbegin());
+        v.Erase(v.cbegin() + SIZE / 2);
+        assert(v.Size() == SIZE + 1);
+        assert(*v[0].value == SIZE - 2);
+        assert(*v[SIZE / 2].value == SIZE / 2 - 1);
+        assert(Handle::num_destroyed == 2);
+        assert(Handle::num_moved == 0);
+    }
+    {
+        // Тривиально копируемые типы переносятся memcpy по умолчанию
+        static_assert(is_trivially_relocatable_v<int>);
+        static_assert(!is_trivially_relocatable_v<Obj>);
+        Vector<int> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.Insert(v.cbegin(), i);
+        }
+        for (int i = 0; i < SIZE; ++i) {
+            assert(v[i] == SIZE - 1 - i);
+        }
+        v.Erase(v.cbegin() + 3);
+        assert(v[3] == SIZE - 5);
+    }
+}
+
+void Test9() {
+    const int SIZE = 1'000'000;
+    {
+        // Буфер растёт через realloc, при большом размере — через mremap без копирования
+        Vector<int, MallocAllocator<int>> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == static_cast<size_t>(SIZE));
+        assert(v.Capacity() >= v.Size());
+        v.Insert(v.cbegin(), v[SIZE - 1]);
+        v.Emplace(v.cbegin() + 1, -1);
+        assert(v[0] == SIZE - 1);
+        assert(v[1] == -1);
+        assert(v[2] == 0);
+        assert(v[SIZE + 1] == SIZE - 1);
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() == static_cast<size_t>(SIZE) * 4);
+        assert(v[SIZE / 2 + 2] == SIZE / 2);
+    }
+    {
+        Handle::ResetCounters();
+        Vector<Handle, MallocAllocator<Handle>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+            v.EmplaceBack(v[v.Size() - 1]);
+        }
+        assert(v.Size() == 200);
+        assert(*v[199].value == 99);
+        assert(Handle::num_moved == 0);
+        assert(Handle::num_copied == 100);
+        const Vector<Handle, MallocAllocator<Handle>> v_copy(v);
+        assert(*v_copy[198].value == 99);
+    }
+    assert(Handle::num_destroyed == 400);
+}
+
+void Test10() {
+    {
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+            if (capacities.empty() || capacities.back() != v.Capacity()) {
+                capacities.push_back(v.Capacity());
+            }
+        }
+        assert((capacities == std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+    }
+    {
+        // Первое выделение занимает целую кэш-линию
+        Vector<int, std::allocator<int>, MinInitialCapacity<DoublingGrowth>> v;
+        v.EmplaceBack(1);
+        assert(v.Capacity() == CACHE_LINE_SIZE / sizeof(int));
+        v.Insert(v.cbegin(), 0);
+        assert(v.Capacity() == CACHE_LINE_SIZE / sizeof(int));
+        // Явный Reserve политикой не округляется
+        v.Reserve(17);
+        assert(v.Capacity() == 17);
+    }
+    {
+        Vector<char, std::allocator<char>, SizeClassRounding<OneAndHalfGrowth>> v;
+        v.PushBack('a');
+        assert(v.Capacity() == 16);
+        assert((SizeClassRounding<DoublingGrowth>::NextCapacity(50, 51, 1) == 112));
+        assert((SizeClassRounding<DoublingGrowth>::NextCapacity(3000, 3001, 2) == 6144));
+    }
+    {
+        assert((CappedGrowth<DoublingGrowth, 1024>::NextCapacity(10'000, 10'001, 4) == 10'256));
+        assert((CappedGrowth<DoublingGrowth, 1024>::NextCapacity(10, 11, 4) == 20));
+        assert((CappedGrowth<DoublingGrowth, 1024>::NextCapacity(10'000, 20'000, 4) == 20'000));
+        const size_t MB = 1024 * 1024;
+        assert((HugePageRounding<OneAndHalfGrowth>::NextCapacity(2 * MB, 2 * MB + 1, 1) == 4 * MB));
+        assert((HugePageRounding<OneAndHalfGrowth>::NextCapacity(1000, 1001, 1) == 1500));
+    }
+}
+
+void Test11() {
+    const size_t INLINE = 4;
+    using namespace std::literals;
+    using Alloc = CountingAllocator<Obj>;
+    {
+        Obj::ResetCounters();
+        Alloc::Counters counters;
+        {
+            SmallVector<Obj, INLINE, Alloc> v{Alloc(&counters)};
+            for (size_t i = 0; i < INLINE; ++i) {
+                v.EmplaceBack(static_cast<int>(i), "obj"s);
+            }
+            v.Erase(v.cbegin() + 1);
+            v.Insert(v.cbegin(), Obj{-1});
+            // Пока элементы помещаются во встроенный буфер, память не выделяется
+            assert(counters.allocations == 0);
+            assert(v.IsInline());
+            assert(v.Capacity() == INLINE);
+            assert(v.Size() == INLINE);
+            v.Emplace(v.cbegin() + 2, -2);
+            v.PushBack(Obj{100});
+            assert(!v.IsInline());
+            assert(counters.allocations == 1);
+            assert(v.Capacity() == INLINE * 2);
+            assert(v.Size() == INLINE + 2);
+            assert(v[0].id == -1);
+            assert(v[1].id == 0);
+            assert(v[2].id == -2);
+            assert(v[3].id == 2);
+            assert(v[INLINE].id == 3);
+            assert(v[INLINE + 1].id == 100);
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(INLINE) + 2);
+        }
+        assert(counters.allocations == counters.deallocations);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Обмен во всех сочетаниях встроенного буфера и буфера в куче
+        Obj::ResetCounters();
+        SmallVector<Obj, INLINE> a(2);
+        SmallVector<Obj, INLINE> b(3);
+        SmallVector<Obj, INLINE> c(INLINE * 3);
+        SmallVector<Obj, INLINE> d(INLINE * 4);
+        a[0].id = 1;
+        b[0].id = 2;
+        c[0].id = 3;
+        d[0].id = 4;
+        a.Swap(b);
+        assert(a.Size() == 3 && a[0].id == 2 && a.IsInline());
+        assert(b.Size() == 2 && b[0].id == 1 && b.IsInline());
+        a.Swap(c);
+        assert(a.Size() == INLINE * 3 && a[0].id == 3 && !a.IsInline());
+        assert(c.Size() == 3 && c[0].id == 2 && c.IsInline());
+        c.Swap(a);
+        assert(c.Size() == INLINE * 3 && !c.IsInline());
+        assert(a.Size() == 3 && a.IsInline());
+        c.Swap(d);
+        assert(c.Size() == INLINE * 4 && c[0].id == 4);
+        assert(d.Size() == INLINE * 3 && d[0].id == 3);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(2 + 3 + INLINE * 7));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, INLINE> v(2);
+        v[1].id = 42;
+        SmallVector<Obj, INLINE> moved(std::move(v));
+        assert(moved.Size() == 2 && moved[1].id == 42 && moved.IsInline());
+        assert(v.Size() == 0);
+        SmallVector<Obj, INLINE> copy(moved);
+        assert(copy.Size() == 2 && copy[1].id == 42);
+        copy.Resize(INLINE * 2);
+        SmallVector<Obj, INLINE> heap_moved(std::move(copy));
+        assert(heap_moved.Size() == INLINE * 2 && !heap_moved.IsInline());
+        assert(copy.Size() == 0 && copy.IsInline());
+        copy = heap_moved;
+        assert(copy.Size() == INLINE * 2 && copy[1].id == 42);
+        copy = moved;
+        assert(copy.Size() == 2 && copy.Capacity() == INLINE * 2);
+        copy.PopBack();
+        assert(copy.Size() == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<TestObj, INLINE> v(INLINE);
+        v.Insert(v.cbegin() + 1, v[0]);
+        v.EmplaceBack(v[0]);
+        v.Insert(v.cbegin(), std::move(v[2]));
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+}
+
+void Test12() {
+    const size_t SIZE = 10;
+    const size_t COUNT = 4;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> src;
+        for (int i = 0; i < static_cast<int>(COUNT); ++i) {
+            src.emplace_back(i + 1);
+        }
+        Obj::ResetCounters();
+        auto pos = v.Insert(v.cbegin() + 2, src.begin(), src.end());
+        // Буфер перевыделяется один раз, каждый старый элемент перемещается один раз
+        assert(pos == v.begin() + 2);
+        assert(v.Size() == SIZE + COUNT);
+        assert(v.Capacity() == SIZE * 2);
+        assert(Obj::num_copied == static_cast<int>(COUNT));
+        assert(Obj::num_moved == static_cast<int>(SIZE));
+        assert(v[2].id == 1 && v[5].id == 4 && v[6].id == 0);
+
+        // Вставка в середину без перевыделения: хвост сдвигается один раз
+        Obj::ResetCounters();
+        v.Insert(v.cbegin() + 1, src.begin(), src.begin() + 2);
+        assert(v.Size() == SIZE + COUNT + 2);
+        assert(Obj::num_moved + Obj::num_move_assigned == static_cast<int>(SIZE + COUNT - 1));
+        assert(v[1].id == 1 && v[2].id == 2 && v[3].id == 0 && v[4].id == 1);
+
+        v.Insert(v.cend() - 1, 3, Obj{7});
+        assert(v.Size() == SIZE + COUNT + 5);
+        assert(v[v.Size() - 4].id == 7 && v[v.Size() - 2].id == 7 && v[v.Size() - 1].id == 0);
+    }
+    {
+        Vector<int> v;
+        const int values[] = {1, 2, 3, 4, 5};
+        v.Append(std::begin(values), std::end(values));
+        v.AppendRange(std::list<int>{6, 7});
+        std::istringstream input("8 9 10");
+        v.Append(std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(v.Size() == 10);
+        for (int i = 0; i < 10; ++i) {
+            assert(v[i] == i + 1);
+        }
+        std::istringstream middle("-1 -2");
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(middle), std::istream_iterator<int>());
+        assert(v[0] == 1 && v[1] == -1 && v[2] == -2 && v[3] == 2 && v.Size() == 12);
+
+        // Вставка собственного диапазона и собственного элемента
+        v.Insert(v.cbegin(), v.begin() + 1, v.begin() + 4);
+        assert(v[0] == -1 && v[1] == -2 && v[2] == 2 && v[3] == 1 && v.Size() == 15);
+        v.Reserve(100);
+        v.Insert(v.cbegin(), v.begin(), v.end());
+        assert(v.Size() == 30 && v[15] == -1 && v[29] == 10);
+        v.Insert(v.cbegin(), 2, v[29]);
+        assert(v[0] == 10 && v[1] == 10 && v[2] == -1);
+        v.Insert(v.cbegin(), size_t{0}, 5);
+        assert(v.Size() == 32);
+    }
+    {
+        Vector<TestObj> v(SIZE);
+        v.Insert(v.cbegin() + 1, v.begin(), v.end());
+        v.Insert(v.cbegin(), 3, v[SIZE]);
+        assert(v.Size() == SIZE * 2 + 3);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+}
+
+void Test13() {
+    const int SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        Obj::ResetCounters();
+        auto pos = v.Erase(v.cbegin() + 10, v.cbegin() + 20);
+        assert(pos == v.begin() + 10);
+        assert(pos->id == 20);
+        assert(v.Size() == static_cast<size_t>(SIZE - 10));
+        assert(Obj::num_move_assigned == SIZE - 20);
+        assert(Obj::num_destroyed == 10);
+        assert(v.Erase(v.cbegin(), v.cbegin()) == v.begin());
+
+        Obj::ResetCounters();
+        const size_t erased = v.EraseIf([](const Obj& obj) {
+            return obj.id % 3 == 0;
+        });
+        assert(erased == 31);
+        assert(v.Size() == static_cast<size_t>(SIZE - 10 - 31));
+        assert(std::none_of(v.begin(), v.end(), [](const Obj& obj) {
+            return obj.id % 3 == 0;
+        }));
+        assert(Obj::num_destroyed == 31);
+        assert(Obj::num_copied == 0);
+    }
+    {
+        Vector<int> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.EraseIf([](int value) {
+            return value % 2 == 1;
+        }) == static_cast<size_t>(SIZE / 2));
+        for (int i = 0; i < SIZE / 2; ++i) {
+            assert(v[i] == i * 2);
+        }
+        v.Erase(v.cbegin(), v.cend());
+        assert(v.Size() == 0);
+        assert(v.EraseIf([](int) {
+            return true;
+        }) == 0);
+    }
+    {
+        Handle::ResetCounters();
+        Vector<Handle> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(v.Size() == 7 && *v[2].value == 5);
+        assert(Handle::num_destroyed == 3 && Handle::num_moved == 0);
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 1000;
+    {
+        Vector<char> v;
+        v.ResizeDefaultInit(SIZE);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE);
+        std::memset(v.begin(), 'x', v.Size());
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2 && v[SIZE / 2 - 1] == 'x');
+
+        Span<char> chunk = v.AppendUninitialized(4);
+        assert(chunk.Size() == 4);
+        assert(chunk.Data() == v.begin() + SIZE / 2);
+        std::memcpy(chunk.Data(), "abcd", 4);
+        assert(v.Size() == SIZE / 2 + 4);
+        assert(v[SIZE / 2] == 'a' && v[SIZE / 2 + 3] == 'd');
+    }
+    {
+        Vector<float> v;
+        for (size_t i = 0; i < 10; ++i) {
+            Span<float> chunk = v.AppendUninitialized(SIZE);
+            for (float& value : chunk) {
+                value = static_cast<float>(i);
+            }
+        }
+        assert(v.Size() == SIZE * 10);
+        // Вместимость растёт по политике, а не ровно под запрос
+        assert(v.Capacity() == SIZE * 16);
+        assert(v[SIZE * 9 + 1] == 9.0F);
+        const ConstSpan<float> empty = v.AppendUninitialized(0);
+        assert(empty.Empty());
+    }
+    {
+        struct Point {
+            int x = 0;
+            int y = 0;
+        };
+        static_assert(detail::is_implicit_lifetime_v<int>);
+        static_assert(detail::is_implicit_lifetime_v<Point>);
+        static_assert(!detail::is_implicit_lifetime_v<TestObj>);
+        static_assert(!detail::is_implicit_lifetime_v<Obj>);
+        static_assert(!detail::is_implicit_lifetime_v<std::string>);
+    }
+}
+
+#if defined(ADVANCED_VECTOR_STATS)
+// Статистика последнего разрушенного вектора, переданная через SetVectorStatsCallback
+VectorInstanceStats last_destroyed_stats;
+#endif
+
+// Тесты собираются в двух вариантах: без ADVANCED_VECTOR_STATS и с ним
+void Test15() {
+#if !defined(ADVANCED_VECTOR_STATS)
+    // Без макроса статистика не занимает места в векторе
+    static_assert(sizeof(Vector<int>) == sizeof(RawMemory<int, std::allocator<int>>) + sizeof(size_t));
+#else
+    ResetVectorAllocationStats();
+    {
+        Vector<int> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        // Вместимость 1, 2, 4, ..., 128: восемь буферов, из которых семь уже освобождены
+        const VectorInstanceStats stats = v.Stats();
+        assert(stats.element_size == sizeof(int));
+        assert(stats.reallocations == 8);
+        assert(stats.relocated_elements == 127);
+        assert(stats.reserve_calls == 0);
+        assert(stats.peak_size == 100 && stats.peak_capacity == 128);
+
+        const VectorAllocationStats allocations = GetVectorAllocationStats();
+        assert(allocations.allocations == 8);
+        assert(allocations.deallocations == 7);
+        assert(allocations.allocated_bytes == 255 * sizeof(int));
+        assert(allocations.deallocated_bytes == 127 * sizeof(int));
+
+        v.Erase(v.begin(), v.end() - 10);
+        v.PopBack();
+        assert(v.Stats().peak_size == 100);
+        assert(v.Stats().peak_capacity == 128);
+    }
+    assert(GetVectorAllocationStats().deallocated_bytes == 255 * sizeof(int));
+
+    SetVectorStatsCallback([](const VectorInstanceStats& stats) {
+        last_destroyed_stats = stats;
+    });
+    {
+        Vector<std::string> v;
+        v.Reserve(64);
+        for (int i = 0; i < 64; ++i) {
+            v.EmplaceBack(std::to_string(i));
+        }
+        v.Resize(8);
+    }
+    SetVectorStatsCallback(nullptr);
+    assert(last_destroyed_stats.element_size == sizeof(std::string));
+    // Resize расширяет буфер сам и не считается вызовом Reserve
+    assert(last_destroyed_stats.reserve_calls == 1);
+    assert(last_destroyed_stats.reallocations == 1);
+    assert(last_destroyed_stats.relocated_elements == 0);
+    assert(last_destroyed_stats.peak_size == 64);
+    assert(last_destroyed_stats.peak_capacity == 64);
+    {
+        // Рост через Resize и AppendUninitialized не выглядит как предварительный Reserve
+        Vector<int> v;
+        v.Resize(4);
+        v.AppendUninitialized(16);
+        v.Resize(100);
+        assert(v.Stats().reserve_calls == 0 && v.Stats().reallocations == 3);
+        v.Reserve(10);
+        v.Reserve(execution::par, 200);
+        assert(v.Stats().reserve_calls == 2 && v.Stats().reallocations == 4);
+    }
+    {
+        // Перевыделения in-place через MallocAllocator::reallocate учитываются отдельно
+        ResetVectorAllocationStats();
+        Vector<int, MallocAllocator<int>> v;
+        for (int i = 0; i < 16; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Stats().reallocations == 5);
+        assert(GetVectorAllocationStats().reallocations == 5);
+    }
+    // Без обратного вызова разрушение вектора ничего не сообщает
+    last_destroyed_stats = {};
+    {
+        Vector<int> v(3);
+    }
+    assert(last_destroyed_stats.element_size == 0);
+#endif
+}
+
+// Проверяет ядра simd на всех наборах инструкций, которые поддерживает процессор
+template <typename T>
+void TestSimdKernels() {
+    // Размеры покрывают пустой диапазон, одни хвосты и хвосты после нескольких векторов
+    for (size_t size : {size_t{0}, size_t{1}, size_t{7}, size_t{64}, size_t{100}, size_t{1000}, size_t{70000}}) {
+        Vector<T> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            v[i] = static_cast<T>(i % 61);
+        }
+        simd::detail::SumType<T> expected_sum = 0;
+        for (const T& value : v) {
+            expected_sum += value;
+        }
+        const size_t expected_count = std::count(v.begin(), v.end(), static_cast<T>(5));
+
+        for (simd::Isa isa : {simd::Isa::SCALAR, simd::Isa::VECTOR_128, simd::Isa::AVX2, simd::Isa::AVX512}) {
+            if (isa > simd::CurrentIsa()) {
+                break;
+            }
+            assert(simd::detail::Dispatch<simd::detail::SumKernel>(isa, v.cbegin(), size) == expected_sum);
+            assert(simd::detail::Dispatch<simd::detail::CountKernel>(isa, v.cbegin(), size, static_cast<T>(5)) == expected_count);
+            assert(simd::detail::Dispatch<simd::detail::FindKernel>(isa, v.cbegin(), size, static_cast<T>(60)) == std::min<size_t>(size, 60));
+            assert(simd::detail::Dispatch<simd::detail::FindKernel>(isa, v.cbegin(), size, static_cast<T>(100)) == size);
+            if (size != 0) {
+                const auto [min, max] = simd::detail::Dispatch<simd::detail::MinMaxKernel>(isa, v.cbegin(), size);
+                assert(min == 0 && max == static_cast<T>(std::min<size_t>(size - 1, 60)));
+            }
+
+            Vector<T> filled(size);
+            simd::detail::Dispatch<simd::detail::FillKernel>(isa, filled.begin(), size, static_cast<T>(3));
+            assert(std::count(filled.begin(), filled.end(), static_cast<T>(3)) == static_cast<std::ptrdiff_t>(size));
+
+            Vector<T> doubled(size);
+            simd::detail::Dispatch<simd::detail::TransformKernel>(isa, v.cbegin(), size, doubled.begin(), [](T value) {
+                return value * 2;
+            });
+            Vector<uint8_t> mask(size);
+            simd::detail::Dispatch<simd::detail::CompareKernel>(isa, v.cbegin(), filled.cbegin(), size, mask.begin(), std::less<>{});
+            for (size_t i = 0; i < size; ++i) {
+                assert(doubled[i] == static_cast<T>(v[i] * 2));
+                assert(mask[i] == (v[i] < 3 ? 1 : 0));
+            }
+        }
+    }
+}
+
+void Test16() {
+    TestSimdKernels<uint8_t>();
+    TestSimdKernels<int16_t>();
+    TestSimdKernels<int32_t>();
+    TestSimdKernels<int64_t>();
+    TestSimdKernels<float>();
+    TestSimdKernels<double>();
+    {
+        // Переполнение восьмибитных счётчиков в Count
+        Vector<uint8_t> v(100000);
+        simd::Fill(v, 7);
+        v[99999] = 1;
+        assert(simd::Count(v, 7) == 99999);
+        assert(simd::Sum(v) == 99999 * 7 + 1);
+        assert(simd::Find(v, 1) == v.end() - 1);
+        assert(simd::Contains(v, 1) && !simd::Contains(v, 2));
+        assert(simd::MinMax(v) == std::make_pair(uint8_t{1}, uint8_t{7}));
+
+        Vector<int8_t> negative(100000);
+        simd::Fill(negative, -100);
+        assert(simd::Sum(negative) == -10000000);
+        Vector<int16_t> wide(100000);
+        simd::Fill(wide, -30000);
+        assert(simd::Sum(wide) == -3000000000LL);
+    }
+    {
+        Vector<float> a(1001);
+        Vector<float> b(1001);
+        simd::Fill(a, 1.5F);
+        simd::Fill(b, 2.0F);
+        b[1000] = 0.5F;
+        Vector<float> c(1001);
+        simd::Transform(a, b, c, std::multiplies<>{});
+        assert(c[0] == 3.0F && c[1000] == 0.75F);
+        // Преобразование на месте
+        simd::Transform(c, c, [](float value) {
+            return -value;
+        });
+        assert(c[999] == -3.0F);
+        Vector<uint8_t> mask(1001);
+        simd::Compare(a, b, mask, std::greater<>{});
+        assert(simd::Count(mask, 1) == 1 && mask[1000] == 1);
+
+        // Подходит любой непрерывный диапазон
+        const ConstSpan<float> tail(a.begin() + 1000, 1);
+        assert(simd::Sum(tail) == 1.5F);
+        SmallVector<int32_t, 8> small(5);
+        simd::Fill(small, -2);
+        assert(simd::Sum(small) == -10);
+    }
+}
+
+void Test17() {
+    const auto is_aligned = [](const void* p, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    };
+    {
+        CacheAlignedVector<char> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(static_cast<char>(i));
+            assert(is_aligned(v.begin(), CACHE_LINE_SIZE));
+        }
+        CacheAlignedVector<char> copy = v;
+        assert(is_aligned(copy.begin(), CACHE_LINE_SIZE));
+        assert(simd::Count(copy, char{7}) == 4);
+    }
+    {
+        struct alignas(128) Block {
+            int value = 0;
+        };
+        static_assert(AlignedAllocator<Block>::ALIGNMENT == 128);
+        Vector<Block, AlignedAllocator<Block>> v(3);
+        assert(is_aligned(v.begin(), 128));
+
+        // Выравнивание до размера страницы
+        Vector<double, AlignedAllocator<double, BASE_PAGE_SIZE>> page(10);
+        assert(is_aligned(page.begin(), BASE_PAGE_SIZE));
+        page.Reserve(1000);
+        assert(is_aligned(page.begin(), BASE_PAGE_SIZE));
+    }
+    {
+        // Копия аллокатора для другого типа сохраняет выравнивание и дополнение
+        using Alloc = AlignedAllocator<int, 32, true>;
+        using Rebound = std::allocator_traits<Alloc>::rebind_alloc<double>;
+        static_assert(std::is_same_v<Rebound, AlignedAllocator<double, 32, true>>);
+        SmallVector<int, 2, Alloc> small;
+        for (int i = 0; i < 5; ++i) {
+            small.PushBack(i);
+        }
+        assert(!small.IsInline() && is_aligned(small.begin(), 32));
+    }
+}
+
+// Объект со счётчиками, безопасными для параллельного создания и разрушения
+struct ParallelObj {
+    ParallelObj() {
+        if (construction_throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
+    }
+    ParallelObj(const ParallelObj& other)
+        : value(other.value) {
+        if (construction_throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++num_alive;
+    }
+    ParallelObj& operator=(const ParallelObj& other) = default;
+    ~ParallelObj() {
+        --num_alive;
+    }
+
+    int value = 1;
+
+    // Конструктор, уменьшивший счётчик с 1 до 0, выбрасывает исключение
+    inline static std::atomic<long> construction_throw_countdown = 0;
+    inline static std::atomic<long> num_alive = 0;
+};
+
+void Test18() {
+    const execution::ParallelPolicy POLICY{4};
+    // Достаточно элементов, чтобы работа делилась между всеми потоками
+    const size_t SIZE = 4 * PARALLEL_MIN_CHUNK_BYTES / sizeof(ParallelObj) + 123;
+    {
+        Vector<ParallelObj> v(POLICY, SIZE);
+        assert(v.Size() == SIZE && ParallelObj::num_alive == static_cast<long>(SIZE));
+        v[SIZE - 1].value = 7;
+
+        Vector<ParallelObj> copy(POLICY, v);
+        assert(copy.Size() == SIZE && copy[SIZE - 1].value == 7);
+        assert(ParallelObj::num_alive == static_cast<long>(2 * SIZE));
+
+        copy.Reserve(POLICY, 2 * SIZE);
+        assert(copy.Capacity() == 2 * SIZE && copy[SIZE - 1].value == 7);
+        assert(ParallelObj::num_alive == static_cast<long>(2 * SIZE));
+
+        copy.Clear(POLICY);
+        assert(copy.Size() == 0 && copy.Capacity() == 2 * SIZE);
+        v.Clear();
+        assert(ParallelObj::num_alive == 0);
+    }
+    for (long countdown : {1L, static_cast<long>(SIZE / 2), static_cast<long>(SIZE)}) {
+        // Исключение в одной из частей: созданные части разрушаются, память освобождается
+        ParallelObj::construction_throw_countdown = countdown;
+        try {
+            Vector<ParallelObj> v(POLICY, SIZE);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(ParallelObj::num_alive == 0);
+    }
+    {
+        ParallelObj::construction_throw_countdown = 0;
+        Vector<ParallelObj> v(POLICY, SIZE);
+        ParallelObj::construction_throw_countdown = static_cast<long>(SIZE / 3);
+        try {
+            // ParallelObj не перемещается без исключений, поэтому Reserve копирует
+            v.Reserve(POLICY, SIZE + 1);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == SIZE && ParallelObj::num_alive == static_cast<long>(SIZE));
+    }
+    {
+        // Тривиально переносимые элементы копируются частями через memcpy
+        Vector<int> v(POLICY, SIZE);
+        v[SIZE - 1] = 5;
+        v.Reserve(POLICY, SIZE * 3);
+        assert(v.Capacity() == SIZE * 3 && v[SIZE - 1] == 5 && v[0] == 0);
+        v.Clear(execution::par);
+        assert(v.Size() == 0);
+    }
+}
+
+void Test19() {
+    MmapOptions options;
+    options.threshold_bytes = 64 * 1024;
+    {
+        // Буфер растёт через mremap, переходя порог отображения
+        Vector<int, MmapAllocator<int>> v{MmapAllocator<int>(options)};
+        for (int i = 0; i < 1'000'000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == 1'000'000 && v[999'999] == 999'999 && v[10] == 10);
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % BASE_PAGE_SIZE == 0);
+
+        Vector<int, MmapAllocator<int>> copy = v;
+        assert(copy.GetAllocator() == v.GetAllocator());
+        assert(copy[123'456] == 123'456);
+        copy = Vector<int, MmapAllocator<int>>();
+        // Параметры аллокатора распространяются вместе с буфером
+        assert(copy.GetAllocator().GetOptions().threshold_bytes == MmapOptions().threshold_bytes);
+    }
+    for (MmapOptions::HugePages huge_pages :
+         {MmapOptions::HugePages::NONE, MmapOptions::HugePages::TRANSPARENT, MmapOptions::HugePages::EXPLICIT}) {
+        // Без зарезервированных огромных страниц EXPLICIT откатывается к TRANSPARENT
+        options.huge_pages = huge_pages;
+        options.numa = MmapOptions::Numa::INTERLEAVE;
+        options.node_mask = 1;
+        Vector<std::string, MmapAllocator<std::string>> v{MmapAllocator<std::string>(options)};
+        v.Reserve(10'000);
+        for (int i = 0; i < 10'000; ++i) {
+            v.EmplaceBack(std::to_string(i));
+        }
+        v.Reserve(20'000);
+        assert(v[9'999] == "9999");
+    }
+    {
+        // Первое обращение к страницам — в потоках, создающих свои части вектора
+        options.numa = MmapOptions::Numa::DEFAULT;
+        const size_t size = 4 * PARALLEL_MIN_CHUNK_BYTES / sizeof(double);
+        Vector<double, MmapAllocator<double>> v(execution::ParallelPolicy{4}, size, MmapAllocator<double>(options));
+        assert(v.Size() == size && v[size - 1] == 0.0);
+    }
+    {
+        HugePageVector<char> v;
+        v.Resize(3 * 1024 * 1024);
+        assert(reinterpret_cast<uintptr_t>(v.begin()) % HUGE_PAGE_SIZE == 0);
+        v.PushBack('x');
+        assert(v.Capacity() % HUGE_PAGE_SIZE == 0 && v[3 * 1024 * 1024] == 'x');
+    }
+}
+
+void Test20() {
+    const std::string path = "/tmp/advanced_vector_test_" + std::to_string(::getpid()) + ".bin";
+    struct Record {
+        int32_t key;
+        float value;
+    };
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 0 && !v.IsReadOnly());
+        for (int i = 0; i < 100'000; ++i) {
+            v.PushBack({i, static_cast<float>(i) / 2});
+        }
+        v.PushBack(v[0]);
+        v.PopBack();
+        v.Flush();
+        assert(v.Size() == 100'000 && v.Capacity() == 131'072);
+    }
+    {
+        // Повторное открытие без копирования элементов
+        const MappedVector<Record> v(path, MappedVector<Record>::Access::READ_ONLY);
+        assert(v.IsReadOnly() && v.Size() == 100'000);
+        assert(v[99'999].key == 99'999 && v[99'999].value == 49'999.5F);
+        int64_t sum = 0;
+        for (const Record& record : v) {
+            sum += record.key;
+        }
+        assert(sum == 4'999'950'000);
+        // Представление константного объекта только читает отображённые страницы
+        const ConstSpan<Record> records = v;
+        assert(records.Size() == 100'000 && records[5].key == 5);
+    }
+    {
+        MappedVector<Record> v(path);
+        v.Resize(10);
+        v.Resize(20);
+        assert(v[9].key == 9 && v[19].key == 0);
+        MappedVector<Record> moved(std::move(v));
+        assert(moved.Size() == 20 && v.Size() == 0);
+        moved.Reserve(1'000'000);
+        assert(moved.Capacity() == 1'000'000 && moved[9].key == 9);
+    }
+    try {
+        MappedVector<int16_t> wrong(path);
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    std::remove(path.c_str());
+    try {
+        MappedVector<int> missing(path, MappedVector<int>::Access::READ_ONLY);
+        assert(false);
+    } catch (const std::system_error&) {
+    }
+}
+
+void Test21() {
+    Vector<double> numbers;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.PushBack(i * 0.5);
+    }
+    Vector<std::string> words;
+    for (const char* word : {"zero", "", "two", "a somewhat longer string that does not fit the SSO buffer"}) {
+        words.PushBack(word);
+    }
+    {
+        std::stringstream stream;
+        Serialize(numbers, stream);
+        Serialize(words, stream);
+        const Vector<double> numbers_copy = Deserialize<double>(stream);
+        const Vector<std::string> words_copy = Deserialize<std::string>(stream);
+        assert(numbers_copy.Size() == 1000 && numbers_copy[999] == 499.5);
+        assert(words_copy.Size() == 4 && words_copy[1].empty() && words_copy[3] == words[3]);
+
+        // Тип элементов проверяется по заголовку
+        stream.clear();
+        stream.seekg(0);
+        try {
+            Deserialize<float>(stream);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+    }
+    {
+        Vector<char> buffer;
+        Serialize(numbers, buffer);
+        Serialize(words, buffer);
+        assert(buffer.Size() > sizeof(SerializedHeader) + 1000 * sizeof(double));
+
+        size_t consumed = 0;
+        const Vector<double> numbers_copy = Deserialize<double>(buffer, &consumed);
+        assert(consumed == sizeof(SerializedHeader) + 1000 * sizeof(double));
+        assert(numbers_copy[10] == 5.0);
+        const ConstSpan<char> rest = ConstSpan<char>(buffer).Subspan(consumed);
+        assert(Deserialize<std::string>(rest)[2] == "two");
+
+        // Представление ссылается на байты буфера без копирования
+        const ConstSpan<double> view = DeserializeView<double>(buffer);
+        assert(view.Size() == 1000 && view[999] == 499.5);
+        assert(static_cast<const void*>(view.Data()) == buffer.begin() + sizeof(SerializedHeader));
+
+        try {
+            Deserialize<double>(ConstSpan<char>(buffer).First(consumed - 1));
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+    }
+    {
+        int fds[2];
+        assert(::pipe(fds) == 0);
+        Serialize(numbers, FileDescriptor{fds[1]});
+        Serialize(words, FileDescriptor{fds[1]});
+        ::close(fds[1]);
+        assert(Deserialize<double>(FileDescriptor{fds[0]})[999] == 499.5);
+        assert(Deserialize<std::string>(FileDescriptor{fds[0]})[0] == "zero");
+        ::close(fds[0]);
+    }
+}
+
+void Test22() {
+    size_t num_freed = 0;
+    const auto free_buffer = [&num_freed](auto* buffer, size_t /*capacity*/) {
+        ++num_freed;
+        std::free(buffer);
+    };
+    {
+        // Чужой буфер из C API: создано 3 строки из 4 мест
+        auto* raw = static_cast<std::string*>(std::malloc(4 * sizeof(std::string)));
+        for (int i = 0; i < 3; ++i) {
+            new (raw + i) std::string(10, static_cast<char>('a' + i));
+        }
+        auto v = Vector<std::string>::FromRawBuffer(raw, 3, 4, free_buffer);
+        assert(v.begin() == raw && v.Size() == 3 && v.Capacity() == 4);
+        v.PushBack("d");
+        assert(num_freed == 0);
+        // Рост переносит элементы в память аллокатора и освобождает чужой буфер удалителем
+        v.PushBack("e");
+        assert(num_freed == 1 && v.Capacity() == 8 && v[2] == "cccccccccc" && v[4] == "e");
+    }
+    {
+        // Перевыделение на месте не применяется к чужому буферу
+        auto* raw = static_cast<int*>(std::malloc(2 * sizeof(int)));
+        raw[0] = 1;
+        raw[1] = 2;
+        auto v = Vector<int, MallocAllocator<int>>::FromRawBuffer(raw, 2, 2, free_buffer);
+        v.PushBack(3);
+        assert(num_freed == 2 && v.Capacity() == 4 && v[0] == 1 && v[2] == 3);
+    }
+    {
+        // Буфер, выделенный тем же аллокатором, принимается без удалителя и растёт через realloc
+        auto* raw = MallocAllocator<int>().allocate(1);
+        raw[0] = 7;
+        auto v = Vector<int, MallocAllocator<int>>::FromRawBuffer(raw, 1, 1);
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        assert(v[0] == 7 && v[100] == 99);
+    }
+    {
+        // Передача буфера между стадиями без копирования
+        Vector<std::string> producer;
+        producer.PushBack("payload");
+        const std::string* address = producer.begin();
+        const ReleasedBuffer<std::string> buffer = producer.ReleaseBuffer();
+        assert(producer.Size() == 0 && producer.Capacity() == 0 && producer.begin() == nullptr);
+        assert(buffer.data == address && buffer.size == 1 && buffer.capacity == 1);
+
+        auto consumer = Vector<std::string>::FromRawBuffer(buffer.data, buffer.size, buffer.capacity);
+        assert(consumer.begin() == address && consumer[0] == "payload");
+
+        // Чужой буфер возвращается без вызова удалителя
+        auto* raw = static_cast<int*>(std::malloc(sizeof(int)));
+        auto adopted = Vector<int>::FromRawBuffer(raw, 0, 1, free_buffer);
+        const ReleasedBuffer<int> released = adopted.ReleaseBuffer();
+        assert(released.data == raw && num_freed == 2);
+        std::free(released.data);
+    }
+}
+
+void Test23() {
+    static_assert(SegmentedVector<int>::BLOCK_SIZE == 1024);
+    static_assert(SegmentedVector<char>::BLOCK_SIZE == 4096);
+    static_assert(SegmentedVector<char[1000]>::BLOCK_SIZE == 16);
+    static_assert(std::is_same_v<std::iterator_traits<SegmentedVector<int>::iterator>::iterator_category,
+                                 std::random_access_iterator_tag>);
+    {
+        // Добавление не переносит элементы: указатели, ссылки и итераторы остаются действительными
+        SegmentedVector<std::string, 4> v;
+        std::string& first = v.EmplaceBack("first");
+        const std::string* first_address = &first;
+        const auto it = v.begin();
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        assert(&v[0] == first_address && first == "first" && *it == "first");
+        assert(v.Size() == 101 && v.Capacity() == 104);
+        assert(v[100] == "99" && v[4] == "3");
+        // Аргумент может ссылаться на элемент самого вектора
+        v.PushBack(v[0]);
+        assert(v[101] == "first");
+    }
+    {
+        // Итераторы произвольного доступа
+        SegmentedVector<int, 8> v(20);
+        std::iota(v.begin(), v.end(), 0);
+        assert(v.end() - v.begin() == 20);
+        assert(*(v.begin() + 17) == 17 && v.begin()[9] == 9 && *(v.end() - 1) == 19);
+        std::reverse(v.begin(), v.end());
+        assert(v[0] == 19 && v[19] == 0);
+        std::sort(v.begin(), v.end());
+        const SegmentedVector<int, 8>& cv = v;
+        SegmentedVector<int, 8>::const_iterator cit = v.begin();
+        assert(cit == cv.begin() && *std::lower_bound(cv.begin(), cv.end(), 12) == 12);
+        assert(std::accumulate(cv.cbegin(), cv.cend(), 0) == 190);
+    }
+    {
+        // Resize, PopBack, Clear, Reserve
+        Obj::ResetCounters();
+        SegmentedVector<Obj, 4> v;
+        v.Reserve(10);
+        assert(v.Capacity() == 12 && Obj::GetAliveObjectCount() == 0);
+        v.Resize(10);
+        assert(Obj::num_default_constructed == 10);
+        v.Resize(3);
+        v.PopBack();
+        assert(v.Size() == 2 && Obj::GetAliveObjectCount() == 2);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == 12 && Obj::GetAliveObjectCount() == 0);
+        Obj::ResetCounters();
+    }
+    {
+        // Копирование, перемещение и обмен
+        SegmentedVector<std::string, 2> a;
+        for (int i = 0; i < 5; ++i) {
+            a.PushBack(std::to_string(i));
+        }
+        SegmentedVector<std::string, 2> b = a;
+        assert(b.Size() == 5 && b[4] == "4" && &b[0] != &a[0]);
+        const std::string* address = &a[3];
+        SegmentedVector<std::string, 2> c = std::move(a);
+        assert(a.Size() == 0 && &c[3] == address);
+        b = c;
+        c.PopBack();
+        b.Swap(c);
+        assert(b.Size() == 4 && c.Size() == 5);
+        SegmentedVector<std::string, 2> d;
+        d = std::move(c);
+        assert(d.Size() == 5 && d[2] == "2");
+    }
+    {
+        // Исключение при копировании разрушает уже скопированные элементы
+        SegmentedVector<Obj, 4> v;
+        v.Resize(6);
+        v[5].throw_on_copy = true;
+        try {
+            SegmentedVector<Obj, 4> copy = v;
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 6);
+        v.Clear();
+        Obj::ResetCounters();
+    }
+}
+
+void Test24() {
+    {
+        // Рост переносит не больше MigrationStep старых элементов за добавление
+        IncrementalVector<std::string, std::allocator<std::string>, DoublingGrowth, 2> v;
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        assert(!v.IsMigrating() && v.Capacity() == 8);
+        const std::string* old_first = &v[0];
+        v.PushBack("8");
+        assert(v.IsMigrating() && v.Capacity() == 16);
+        // Два первых элемента уже в новом буфере, остальные ещё в старом
+        assert(&v[0] != old_first && &v[2] == old_first + 2);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == std::to_string(i));
+        }
+        v.PushBack("9");
+        v.PushBack("10");
+        assert(v.IsMigrating());
+        v.PushBack("11");
+        // 8 элементов перенесены за 4 добавления
+        assert(!v.IsMigrating());
+        int expected = 0;
+        for (const std::string& s : v) {
+            assert(s == std::to_string(expected++));
+        }
+        assert(expected == 12);
+    }
+    {
+        // FinishMigration, Reserve и аргумент, ссылающийся на элемент в старом буфере
+        IncrementalVector<std::string> v;
+        for (int i = 0; i < 64; ++i) {
+            v.PushBack(std::string(20, static_cast<char>('a' + i % 26)));
+        }
+        v.PushBack(v[63]);
+        assert(v.IsMigrating() && v[64] == v[63]);
+        v.FinishMigration();
+        assert(!v.IsMigrating() && v.Size() == 65 && v[10] == std::string(20, 'k'));
+        v.PushBack("x");
+        assert(v.IsMigrating() || v.Size() < v.Capacity());
+        v.Reserve(1000);
+        assert(!v.IsMigrating() && v.Capacity() == 1000 && v[65] == "x");
+    }
+    {
+        // PopBack и Resize во время переноса, разрушение всех элементов
+        Obj::ResetCounters();
+        {
+            IncrementalVector<Obj, std::allocator<Obj>, DoublingGrowth, 1> v;
+            v.Resize(16);
+            v.EmplaceBack();
+            assert(v.IsMigrating() && Obj::GetAliveObjectCount() == 17);
+            v.Resize(8);
+            assert(Obj::GetAliveObjectCount() == 8 && v.IsMigrating());
+            v.PopBack();
+            v.PopBack();
+            v.Resize(20);
+            assert(Obj::GetAliveObjectCount() == 20);
+            IncrementalVector<Obj, std::allocator<Obj>, DoublingGrowth, 1> copy = v;
+            assert(!copy.IsMigrating() && copy.Size() == 20 && Obj::GetAliveObjectCount() == 40);
+            v.Swap(copy);
+            v.Clear();
+            assert(v.Size() == 0 && !v.IsMigrating() && Obj::GetAliveObjectCount() == 20);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        Obj::ResetCounters();
+    }
+    {
+        // Итераторы произвольного доступа по обоим буферам
+        IncrementalVector<int, MallocAllocator<int>> v;
+        for (int i = 0; i < 33; ++i) {
+            v.PushBack(32 - i);
+        }
+        assert(v.IsMigrating());
+        std::sort(v.begin(), v.end());
+        for (int i = 0; i < 33; ++i) {
+            assert(v[i] == i);
+        }
+        IncrementalVector<int, MallocAllocator<int>> moved = std::move(v);
+        assert(v.Size() == 0 && moved.Size() == 33 && moved.end() - moved.begin() == 33);
+    }
+}
+
+void Test25() {
+    {
+        // ShrinkToFit и ShrinkTo не опускают вместимость ниже размера
+        Vector<std::string> v;
+        v.Reserve(100);
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        v.ShrinkTo(50);
+        assert(v.Capacity() == 50 && v.Size() == 10 && v[9] == "9");
+        v.ShrinkTo(200);
+        assert(v.Capacity() == 50);
+        v.ShrinkTo(0);
+        assert(v.Capacity() == 10);
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0 && v.begin() == nullptr);
+    }
+    {
+        // Тривиально переносимые элементы сжимаются через reallocate, чужой буфер переносится к аллокатору
+        Vector<int, MallocAllocator<int>> v(1000);
+        std::iota(v.begin(), v.end(), 0);
+        v.Resize(3);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 3 && v[2] == 2);
+
+        size_t num_freed = 0;
+        auto* raw = static_cast<int*>(std::malloc(100 * sizeof(int)));
+        raw[0] = 42;
+        auto adopted = Vector<int, MallocAllocator<int>>::FromRawBuffer(raw, 1, 100, [&num_freed](int* p, size_t) {
+            ++num_freed;
+            std::free(p);
+        });
+        adopted.ShrinkToFit();
+        assert(num_freed == 1 && adopted.Capacity() == 1 && adopted[0] == 42);
+    }
+    {
+        // Сжатие с гистерезисом: ниже четверти вместимости буфер уменьшается до удвоенного размера
+        Vector<int, std::allocator<int>, HysteresisShrink<DoublingGrowth>> v;
+        for (int i = 0; i < 64; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 64);
+        while (v.Size() > 16) {
+            v.PopBack();
+        }
+        assert(v.Capacity() == 64);
+        v.PopBack();
+        assert(v.Size() == 15 && v.Capacity() == 30 && v[14] == 14);
+        // Чередование добавления и удаления на границе не перевыделяет буфер
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+            v.PopBack();
+        }
+        assert(v.Capacity() == 30);
+        // Erase возвращает итератор в новый буфер
+        const auto it = v.Erase(v.begin() + 1, v.begin() + 10);
+        assert(v.Size() == 6 && v.Capacity() == 12 && it == v.begin() + 1 && *it == 10);
+        v.EraseIf([](int value) {
+            return value != 0;
+        });
+        assert(v.Size() == 1 && v.Capacity() == 2);
+        v.Resize(0);
+        assert(v.Capacity() == 0);
+        // Clear буфер не сжимает
+        v.Resize(40);
+        v.Clear();
+        assert(v.Capacity() == 40);
+    }
+    {
+        // Политика сжатия округляет вместимость как при росте
+        using Policy = HysteresisShrink<MinInitialCapacity<DoublingGrowth>>;
+        Vector<char, std::allocator<char>, Policy> v(1000);
+        v.Resize(1);
+        assert(v.Capacity() == CACHE_LINE_SIZE);
+    }
+#if defined(ADVANCED_VECTOR_STATS)
+    {
+        Vector<int> v(100);
+        v.Resize(10);
+        v.ShrinkToFit();
+        const VectorInstanceStats stats = v.Stats();
+        assert(stats.reallocations == 1 && stats.relocated_elements == 10 && stats.peak_capacity == 100);
+    }
+#endif
+}
+
+struct ThrowingCtor {
+    explicit ThrowingCtor(int value)
+        : value(value) {
+        if (value < 0) {
+            throw std::runtime_error("negative");
+        }
+    }
+    int value;
+};
+
+void Test26() {
+    {
+        // Одновременные PushBack из нескольких потоков: каждое значение попадает ровно в одну ячейку
+        constexpr int NUM_THREADS = 4;
+        constexpr int PER_THREAD = 5000;
+        ConcurrentVector<int> v(4);
+        std::atomic<bool> stop_reader{false};
+        std::atomic<size_t> max_snapshot{0};
+        std::thread reader([&] {
+            while (!stop_reader.load()) {
+                const Vector<int> snapshot = v.Snapshot();
+                max_snapshot = std::max(max_snapshot.load(), snapshot.Size());
+            }
+        });
+        std::vector<std::thread> writers;
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            writers.emplace_back([&v, t] {
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    const int value = t * PER_THREAD + i;
+                    const size_t index = v.PushBack(value);
+                    assert(v[index] == value);
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        stop_reader = true;
+        reader.join();
+        assert(v.Size() == NUM_THREADS * PER_THREAD && max_snapshot <= v.Size());
+        std::vector<bool> seen(NUM_THREADS * PER_THREAD);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v.IsPublished(i) && !seen[v[i]]);
+            seen[v[i]] = true;
+        }
+        assert(!v.IsPublished(v.Size()) && v.TryGet(v.Size()) == nullptr);
+
+        // Элементы в нескольких сегментах перемещаются в новый буфер
+        const int* first = &v[0];
+        Vector<int> frozen = std::move(v).Freeze();
+        assert(frozen.Size() == NUM_THREADS * PER_THREAD && frozen.begin() != first && v.Size() == 0);
+    }
+    {
+        // Все элементы в первом сегменте: Freeze отдаёт его буфер без копирования
+        ConcurrentVector<std::string> v(100);
+        for (int i = 0; i < 50; ++i) {
+            v.EmplaceBack(std::to_string(i));
+        }
+        const std::string* first = &v[0];
+        const std::string* element = &v.EmplaceBack("ref");
+        assert(element == &v[50]);
+        Vector<std::string> frozen = std::move(v).Freeze();
+        assert(frozen.begin() == first && frozen.Size() == 51 && frozen.Capacity() == 128 && frozen[49] == "49");
+        frozen.PushBack("grows");
+        assert(frozen.Size() == 52 && frozen[50] == "ref");
+    }
+    {
+        // Ячейка, конструктор элемента которой выбросил исключение, пропускается
+        ConcurrentVector<ThrowingCtor> v(8);
+        v.EmplaceBack(1);
+        try {
+            v.EmplaceBack(-1);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        v.EmplaceBack(3);
+        assert(v.Size() == 3 && !v.IsPublished(1) && v[2].value == 3);
+        const Vector<ThrowingCtor> snapshot = v.Snapshot();
+        assert(snapshot.Size() == 2 && snapshot[1].value == 3);
+        const Vector<ThrowingCtor> frozen = std::move(v).Freeze();
+        assert(frozen.Size() == 2 && frozen[0].value == 1);
+    }
+    {
+        // Разрушение опубликованных элементов во всех сегментах
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj> v(1);
+            for (int i = 0; i < 100; ++i) {
+                v.EmplaceBack();
+            }
+            assert(Obj::GetAliveObjectCount() == 100);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        Obj::ResetCounters();
+    }
+}
+
+void Test27() {
+    {
+        // Пакет записывается в target при заполнении, на Flush и в деструкторе
+        Vector<std::string> target;
+        std::mutex mutex;
+        {
+            BatchAppender<std::string, 4> appender(target, mutex);
+            for (int i = 0; i < 4; ++i) {
+                appender.PushBack(std::to_string(i));
+            }
+            assert(target.Size() == 0 && appender.Pending() == 4);
+            std::string& fifth = appender.EmplaceBack(3, 'x');
+            assert(target.Size() == 4 && appender.Pending() == 1 && fifth == "xxx");
+            appender.Flush();
+            assert(target.Size() == 5 && appender.Pending() == 0 && target[4] == "xxx");
+            appender.Flush();
+            appender.PushBack("tail");
+        }
+        assert(target.Size() == 6 && target[0] == "0" && target[5] == "tail");
+    }
+    {
+        // Многие потоки пишут пакетами: ни один элемент не теряется и не повторяется
+        constexpr int NUM_THREADS = 4;
+        constexpr int PER_THREAD = 10000;
+        Vector<int> target;
+        std::mutex mutex;
+        std::vector<std::thread> writers;
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            writers.emplace_back([&target, &mutex, t] {
+                BatchAppender<int> appender(target, mutex);
+                for (int i = 0; i < PER_THREAD; ++i) {
+                    appender.PushBack(t * PER_THREAD + i);
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        assert(target.Size() == NUM_THREADS * PER_THREAD);
+        std::sort(target.begin(), target.end());
+        for (int i = 0; i < NUM_THREADS * PER_THREAD; ++i) {
+            assert(target[i] == i);
+        }
+        static_assert(BatchAppender<int>::BATCH_SIZE == 1024);
+    }
+    {
+        // Элементы перемещаются в target, не копируются
+        Obj::ResetCounters();
+        Vector<Obj> target;
+        target.Reserve(8);
+        std::mutex mutex;
+        {
+            BatchAppender<Obj, 8> appender(target, mutex);
+            for (int i = 0; i < 8; ++i) {
+                appender.EmplaceBack();
+            }
+        }
+        assert(target.Size() == 8 && Obj::num_copied == 0 && Obj::GetAliveObjectCount() == 8);
+        target.Clear();
+        Obj::ResetCounters();
+    }
+}
+
+void Test28() {
+    using Table = SoAVector<int, double, std::string>;
+    static_assert(Table::NUM_COLUMNS == 3 && Table::ROW_SIZE == sizeof(int) + sizeof(double) + sizeof(std::string));
+    {
+        // Строки через ссылку-заместитель, столбцы через Span
+        Table t;
+        for (int i = 0; i < 10; ++i) {
+            t.EmplaceBack(i, i * 0.5, std::to_string(i));
+        }
+        assert(t.Size() == 10 && t.Capacity() == 16);
+        auto [id, weight, name] = t[3];
+        assert(id == 3 && weight == 1.5 && name == "3");
+        id = 30;
+        std::get<2>(t[3]) += "!";
+        assert(t.Column<0>()[3] == 30 && t.Column<2>()[3] == "3!");
+
+        const Span<int> ids = t.Column<0>();
+        assert(ids.Size() == 10 && simd::Sum(ids) == 45 - 3 + 30);
+        const Table& ct = t;
+        const ConstSpan<double> weights = ct.Column<1>();
+        assert(weights[9] == 4.5);
+        const auto [cid, cweight, cname] = ct[9];
+        assert(cid == 9 && cname == "9");
+        (void)cweight;
+    }
+    {
+        // Insert и Erase сдвигают все столбцы вместе
+        Table t;
+        t.Reserve(4);
+        t.EmplaceBack(1, 1.0, "one");
+        t.EmplaceBack(3, 3.0, "three");
+        t.Insert(1, 2, 2.0, "two");
+        t.Insert(0, 0, 0.0, "zero");
+        assert(t.Size() == 4 && t.Capacity() == 4);
+        // Вставка в полный вектор и аргумент из самого вектора
+        t.Insert(2, std::get<0>(t[0]), std::get<1>(t[1]), std::get<2>(t[3]));
+        assert(t.Size() == 5 && t.Capacity() == 8);
+        const char* expected[] = {"zero", "one", "three", "two", "three"};
+        for (size_t i = 0; i < t.Size(); ++i) {
+            assert(std::get<2>(t[i]) == expected[i]);
+        }
+        t.Erase(2);
+        t.Erase(0, 2);
+        assert(t.Size() == 2 && std::get<0>(t[0]) == 2 && std::get<2>(t[1]) == "three");
+        // Рост с аргументами из самого вектора: строка создаётся до переноса столбцов
+        for (int i = 0; i < 7; ++i) {
+            t.EmplaceBack(std::get<0>(t[1]), std::get<1>(t[1]), std::get<2>(t[1]));
+        }
+        assert(t.Size() == 9 && t.Capacity() == 16 && std::get<2>(t[8]) == "three");
+        t.PopBack();
+        assert(t.Size() == 8);
+    }
+    {
+        // Resize, копирование, перемещение и откат при исключении в одном из столбцов
+        Obj::ResetCounters();
+        {
+            SoAVector<int, Obj> t(5);
+            assert(Obj::num_default_constructed == 5 && std::get<0>(t[4]) == 0);
+            t.Resize(8);
+            t.Resize(2);
+            assert(Obj::GetAliveObjectCount() == 2);
+            SoAVector<int, Obj> copy = t;
+            assert(Obj::GetAliveObjectCount() == 4 && copy.Size() == 2);
+            std::get<1>(t[1]).throw_on_copy = true;
+            try {
+                SoAVector<int, Obj> failed = t;
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(Obj::GetAliveObjectCount() == 4);
+            SoAVector<int, Obj> moved = std::move(copy);
+            assert(copy.Size() == 0 && moved.Size() == 2);
+            std::get<1>(t[1]).throw_on_copy = false;
+            moved = t;
+            moved.Clear();
+            assert(Obj::GetAliveObjectCount() == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        Obj::ResetCounters();
+    }
+}
+
+void Test29() {
+    {
+        // Представления контейнеров библиотеки и стандартных контейнеров
+        Vector<int> v(10);
+        std::iota(v.begin(), v.end(), 0);
+        const Span<int> all = v;
+        assert(all.Data() == v.begin() && all.Size() == 10);
+        const Vector<int>& cv = v;
+        const ConstSpan<int> call = cv;
+        Span deduced = v;
+        static_assert(std::is_same_v<decltype(deduced), Span<int>>);
+        Span const_deduced = cv;
+        static_assert(std::is_same_v<decltype(const_deduced), Span<const int>>);
+        static_assert(!std::is_constructible_v<Span<int>, const Vector<int>&>);
+        static_assert(!std::is_constructible_v<Span<int>, Vector<int>&&>);
+        static_assert(!std::is_constructible_v<Span<int>, Vector<long>&>);
+
+        SmallVector<int, 4> small(3);
+        assert(Span<int>(small).Data() == small.begin() && Span<int>(small).Size() == 3);
+        std::vector<int> standard{1, 2, 3};
+        assert(ConstSpan<int>(standard).Data() == standard.data());
+
+        // Subspan, First, Last
+        assert(call.Subspan(3).Size() == 7 && call.Subspan(3)[0] == 3);
+        assert(call.Subspan(2, 3).Size() == 3 && call.Subspan(2, 3)[2] == 4);
+        assert(call.Subspan(10).Empty());
+        assert(call.First(2)[1] == 1 && call.Last(2)[0] == 8 && call.Last(0).Empty());
+        assert(simd::Sum(call.Subspan(5)) == 5 + 6 + 7 + 8 + 9);
+
+        // Вставка и добавление представлений, в том числе части самого вектора
+        Vector<int> w;
+        w.Append(call.Last(3));
+        w.Insert(w.begin(), call.First(2));
+        assert(w.Size() == 5 && w[0] == 0 && w[1] == 1 && w[2] == 7);
+        w.Append(w);
+        assert(w.Size() == 10 && w[5] == 0 && w[9] == 9);
+        w.Insert(w.begin() + 1, ConstSpan<int>(w).Subspan(8));
+        assert(w.Size() == 12 && w[1] == 8 && w[2] == 9 && w[3] == 1);
+        w.Append(standard);
+        assert(w.Size() == 15 && w[14] == 3);
+    }
+    {
+        // Сериализация части вектора без копии
+        Vector<int> v(100);
+        std::iota(v.begin(), v.end(), 0);
+        Vector<char> buffer;
+        Serialize(ConstSpan<int>(v).Subspan(10, 5), buffer);
+        const Vector<int> restored = Deserialize<int>(buffer);
+        assert(restored.Size() == 5 && restored[0] == 10 && restored[4] == 14);
+
+        Vector<std::string> names;
+        names.PushBack("a");
+        names.PushBack("b");
+        std::stringstream stream;
+        Serialize(ConstSpan<std::string>(names).Last(1), stream);
+        const Vector<std::string> last = Deserialize<std::string>(stream);
+        assert(last.Size() == 1 && last[0] == "b");
+    }
+}
+
+void Test30() {
+    {
+        // Копирование не копирует элементы, константное чтение не отсоединяет
+        Obj::ResetCounters();
+        CowVector<Obj> v(4);
+        v[1].id = 7;
+        const CowVector<Obj> copy = v;
+        assert(Obj::num_copied == 0 && v.UseCount() == 2);
+        assert(copy.begin() == std::as_const(v).begin() && copy[1].id == 7);
+        assert(std::as_const(v)[1].id == 7 && v.View().Size() == 4 && v.UseCount() == 2);
+
+        // Первая запись копирует элементы в собственный буфер
+        v[1].id = 8;
+        assert(Obj::num_copied == 4 && v.UseCount() == 1 && copy.UseCount() == 1);
+        assert(copy[1].id == 7 && std::as_const(v)[1].id == 8);
+        const int num_copied = Obj::num_copied;
+        v[2].id = 9;
+        assert(Obj::num_copied == num_copied);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Изменяющие методы разделяемого вектора
+        CowVector<int> v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        CowVector<int> copy = v;
+        v.PushBack(std::as_const(v)[0]);
+        assert(v.Size() == 6 && v[5] == 0 && copy.Size() == 5);
+        assert(v.Capacity() >= 6);
+
+        copy = v;
+        auto it = v.Insert(v.cbegin() + 1, 10);
+        assert(*it == 10 && v[1] == 10 && v.Size() == 7 && copy[1] == 1);
+        copy = v;
+        it = v.Erase(v.cbegin() + 1, v.cbegin() + 3);
+        assert(*it == 2 && v.Size() == 5 && copy.Size() == 7);
+        copy = v;
+        v.PopBack();
+        v.Resize(2);
+        assert(v.Size() == 2 && copy.Size() == 5);
+
+        // Clear разделяемого вектора просто отпускает буфер
+        copy = v;
+        v.Clear();
+        assert(v.Empty() && v.UseCount() == 0 && copy.Size() == 2 && copy.UseCount() == 1);
+
+        // Take забирает собственный буфер без копирования и копирует разделяемый
+        const int* data = copy.cbegin();
+        Vector<int> taken = std::move(copy).Take();
+        assert(taken.begin() == data && taken.Size() == 2 && copy.Empty());
+        CowVector<int> adopted(std::move(taken));
+        assert(adopted.cbegin() == data && adopted.UseCount() == 1);
+        const CowVector<int> shared = adopted;
+        Vector<int> copied = std::move(adopted).Take();
+        assert(copied.begin() != data && copied.Size() == 2 && shared.cbegin() == data);
+    }
+    {
+        // Исключение при отсоединении оставляет вектор разделяемым и неизменным
+        Obj::ResetCounters();
+        CowVector<Obj> v(3);
+        v[2].throw_on_copy = true;
+        const CowVector<Obj> copy = v;
+        try {
+            v.PushBack(Obj{});
+            assert(false);
+        } catch (const std::runtime_error&) {
+        } catch (...) {
+            assert(false);
+        }
+        assert(v.Size() == 3 && v.UseCount() == 2 && std::as_const(v).begin() == copy.begin());
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Копии можно раздать потокам: каждый читает общий буфер и изменяет только свою копию
+        CowVector<int> config(1000);
+        std::iota(config.begin(), config.end(), 0);
+        const int* shared = config.cbegin();
+        std::vector<std::thread> workers;
+        std::atomic<int> failures{0};
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([copy = config, shared, t, &failures]() mutable {
+                const long long sum = std::accumulate(copy.cbegin(), copy.cend(), 0LL);
+                if (sum != 999 * 1000 / 2 || copy.cbegin() != shared) {
+                    ++failures;
+                }
+                if (t % 2 == 0) {
+                    copy[0] = t;
+                    if (copy.cbegin() == shared || copy.UseCount() != 1) {
+                        ++failures;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        assert(failures == 0 && config.UseCount() == 1 && config.cbegin() == shared && config[0] == 0);
+    }
+}
+
+void Test31() {
+    {
+        // Поиск без ветвлений и по индексу Эйтцингера совпадает с std::lower_bound
+        for (size_t size = 0; size <= 70; ++size) {
+            Vector<int> keys;
+            for (size_t i = 0; i < size; ++i) {
+                keys.PushBack(static_cast<int>(i) * 2);
+            }
+            detail::EytzingerLayout<int> index;
+            index.Build(ConstSpan<int>(keys));
+            for (int key = -1; key <= static_cast<int>(size) * 2 + 1; ++key) {
+                const size_t expected = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+                assert(detail::Branchless_Lower_Bound(keys.begin(), keys.Size(), key, std::less<int>{}) == expected);
+                assert(index.LowerBound(key, std::less<int>{}) == expected);
+            }
+        }
+    }
+    {
+        // FlatSet хранит уникальные ключи по возрастанию
+        const int init[] = {5, 1, 4, 1, 3, 5};
+        FlatSet<int> set(std::begin(init), std::end(init));
+        assert(set.Size() == 4 && std::is_sorted(set.begin(), set.end()));
+        assert(set.Contains(4) && !set.Contains(2) && *set.Find(3) == 3 && set.Find(2) == nullptr);
+        assert(set.LowerBound(2) == 1 && set.LowerBound(6) == 4);
+        assert(set.Insert(2) == std::make_pair(size_t{1}, true));
+        assert(set.Insert(2) == std::make_pair(size_t{1}, false));
+        assert(set.Erase(4) && !set.Erase(4) && set.Size() == 4);
+
+        const int more[] = {9, 0, 3, 7, 9, 0};
+        set.InsertRange(std::begin(more), std::end(more));
+        const int expected[] = {0, 1, 2, 3, 5, 7, 9};
+        assert(std::equal(set.begin(), set.end(), std::begin(expected), std::end(expected)));
+
+        // Индекс используется до первого изменения ключей
+        set.BuildIndex();
+        assert(set.HasIndex() && set.LowerBound(4) == 4 && set.Contains(7) && !set.Contains(8));
+        set.Insert(8);
+        assert(!set.HasIndex() && set.Contains(8));
+    }
+    {
+        // FlatMap: значения в отдельном столбце, при равных ключах остаётся первое значение
+        FlatMap<std::string, int> map;
+        map["b"] = 2;
+        map["a"] = 1;
+        assert(map.Insert("c", 3).second && !map.Insert("a", 10).second && map["a"] == 1);
+        assert(map.TryEmplace("d", map.ValueAt(2)) == std::make_pair(size_t{3}, true) && map["d"] == 3);
+
+        const std::pair<std::string, int> batch[] = {{"e", 5}, {"a", 11}, {"f", 6}, {"e", 50}, {"0", 0}};
+        map.InsertRange(std::begin(batch), std::end(batch));
+        assert(map.Size() == 7 && map.KeyAt(0) == "0" && map.KeyAt(6) == "f");
+        assert(*map.Find("a") == 1 && *map.Find("e") == 5 && map.Find("z") == nullptr);
+        assert(map.Keys().Size() == map.Values().Size() && map.Values()[3] == 3);
+        assert(map.Erase("b") && !map.Contains("b") && map.Size() == 6);
+
+        // Изменение значений не удаляет индекс
+        map.BuildIndex();
+        *map.Find("c") = 30;
+        map.Values()[0] = -1;
+        assert(map.HasIndex() && map["c"] == 30 && map.LowerBound("bb") == 2);
+        map.EraseAt(0);
+        assert(!map.HasIndex() && map.KeyAt(0) == "a");
+    }
+    {
+        // Исключение при копировании пакета оставляет отображение без изменений
+        Obj::ResetCounters();
+        FlatMap<int, Obj> map;
+        map.TryEmplace(1, 10);
+        map.TryEmplace(3, 30);
+        std::vector<std::pair<int, Obj>> batch(3);
+        batch[0].first = 0;
+        batch[1].first = 2;
+        batch[2].first = 4;
+        batch[2].second.throw_on_copy = true;
+        try {
+            map.InsertRange(batch.begin(), batch.end());
+            assert(false);
+        } catch (const std::runtime_error&) {
+        } catch (...) {
+            assert(false);
+        }
+        assert(map.Size() == 2 && map.ValueAt(0).id == 10 && map.ValueAt(1).id == 30);
+        batch[2].second.throw_on_copy = false;
+        map.InsertRange(batch.begin(), batch.end());
+        assert(map.Size() == 5 && map.KeyAt(2) == 2 && map.ValueAt(3).id == 30);
+
+        // Совпадает с std::map на случайных операциях
+        std::map<int, int> reference;
+        FlatMap<int, int> flat;
+        unsigned seed = 1;
+        for (int step = 0; step < 2000; ++step) {
+            seed = seed * 1103515245 + 12345;
+            const int key = static_cast<int>(seed >> 16) % 200;
+            if (step % 3 == 0) {
+                assert((reference.erase(key) == 1) == flat.Erase(key));
+            } else {
+                reference.emplace(key, step);
+                flat.TryEmplace(key, step);
+            }
+        }
+        assert(flat.Size() == reference.size());
+        size_t i = 0;
+        for (const auto& [key, value] : reference) {
+            assert(flat.KeyAt(i) == key && flat.ValueAt(i) == value);
+            ++i;
+        }
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+// Один и тот же код выполняется во время компиляции (C++20) и во время выполнения, где тривиальные
+// элементы сдвигаются memmove, а во время компиляции — перемещением
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR Vector<T> BuildEdited(const T& first, const T& second) {
+    Vector<T> v;
+    v.PushBack(first);
+    v.EmplaceBack(second);
+    v.Insert(v.begin(), second);
+    v.Emplace(v.begin() + 1, v[2]);
+    v.Resize(6);
+    v.Erase(v.begin() + 4);
+    v.Erase(v.begin(), v.begin() + 1);
+    Vector<T> copy = v;
+    copy.PopBack();
+    Vector<T> moved = std::move(copy);
+    moved.Reserve(32);
+    moved.ShrinkToFit();
+    v = moved;
+    return v;
+}
+
+template <size_t N>
+ADVANCED_VECTOR_CONSTEXPR std::array<int, N> MakeSquares() {
+    Vector<int> squares;
+    for (size_t i = 0; i < N; ++i) {
+        squares.PushBack(static_cast<int>(i * i));
+    }
+    std::array<int, N> table{};
+    for (size_t i = 0; i < N; ++i) {
+        table[i] = squares[i];
+    }
+    return table;
+}
+
+void Test32() {
+    {
+        const Vector<int> ints = BuildEdited(1, 2);
+        assert(ints.Size() == 3 && ints[0] == 2 && ints[1] == 1 && ints[2] == 2);
+        const Vector<std::string> strings = BuildEdited<std::string>("a", "b");
+        assert(strings.Size() == 3 && strings[0] == "b" && strings[1] == "a" && strings[2] == "b");
+        assert(MakeSquares<5>()[4] == 16);
+    }
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+    {
+        // Таблица строится при компиляции, память временного Vector освобождается там же
+        constexpr std::array<int, 16> squares = MakeSquares<16>();
+        static_assert(squares[0] == 0 && squares[15] == 225);
+        static_assert(BuildEdited(1, 2).Size() == 3 && BuildEdited(1, 2)[1] == 1);
+        static_assert(BuildEdited<std::string>("a", "b")[2] == "b");
+        static_assert(Vector<double>(4).Capacity() == 4);
+    }
+#endif
+}
+
+void Test33() {
+    using namespace std::literals;
+    {
+        // Тривиально копируемый StaticVector копируется как структура
+        static_assert(std::is_trivially_copyable_v<StaticVector<int, 8>>);
+        static_assert(!std::is_trivially_copyable_v<StaticVector<std::string, 8>>);
+        static_assert(StaticVector<int, 8>::Capacity() == 8);
+
+        StaticVector<int, 8> v{1, 2, 3};
+        v.EmplaceBack(5);
+        v.Insert(v.begin() + 3, 4);
+        assert(v.Emplace(v.begin(), v[4]) == v.begin());
+        assert(v.Size() == 6 && v[0] == 5 && v[1] == 1 && v[4] == 4 && v[5] == 5);
+        v.Erase(v.begin());
+        v.Erase(v.begin() + 1, v.begin() + 3);
+        assert(v.Size() == 3 && v[0] == 1 && v[1] == 4 && v[2] == 5);
+
+        StaticVector<int, 8> copy = v;
+        v.Resize(8);
+        assert(v.IsFull() && v[7] == 0 && copy.Size() == 3);
+        assert(!v.TryPushBack(9) && !v.TryEmplaceBack(9) && v.TryEmplace(v.begin(), 9) == nullptr);
+        assert(v.Size() == 8 && v[0] == 1);
+        assert(copy.TryEmplace(copy.begin() + 1, 7) == copy.begin() + 1 && copy[1] == 7 && copy.Size() == 4);
+    }
+    {
+        StaticVector<std::string, 4, ThrowOnOverflow> v;
+        v.PushBack("one"s);
+        v.EmplaceBack(3, 'x');
+        v.Insert(v.begin(), v[1]);
+        assert(v.Size() == 3 && v[0] == "xxx" && v[1] == "one" && v[2] == "xxx");
+        assert(v.TryEmplaceBack("four"));
+        try {
+            v.Emplace(v.begin(), "five");
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            v.Resize(5);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 4 && v[0] == "xxx" && v[3] == "four");
+
+        StaticVector<std::string, 4, ThrowOnOverflow> moved(std::move(v));
+        assert(moved.Size() == 4 && moved[1] == "one" && v.Size() == 0);
+        StaticVector<std::string, 4, ThrowOnOverflow> small{"a"s};
+        small.Swap(moved);
+        assert(small.Size() == 4 && small[3] == "four" && moved.Size() == 1 && moved[0] == "a");
+        moved = small;
+        assert(moved.Size() == 4 && moved[2] == "xxx");
+        small.Erase(small.begin(), small.begin() + 3);
+        moved = std::move(small);
+        assert(moved.Size() == 1 && moved[0] == "four" && small.Size() == 0);
+    }
+    {
+        // Каждый элемент создаётся и разрушается ровно один раз, в куче память не выделяется
+        Obj::ResetCounters();
+        {
+            StaticVector<Obj, 5> v(2);
+            v.EmplaceBack(1);
+            v.Emplace(v.begin() + 1, 2);
+            v.Erase(v.begin());
+            StaticVector<Obj, 5> copy(v);
+            StaticVector<Obj, 5> moved(std::move(copy));
+            assert(moved.Size() == 3 && moved[0].id == 2 && moved[2].id == 1 && copy.Size() == 0);
+            moved.PopBack();
+            moved.Clear();
+            // Как у Vector, PopBack пустого вектора ничего не делает
+            moved.PopBack();
+            assert(moved.Size() == 0 && Obj::GetAliveObjectCount() == 3);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test34() {
+    {
+        // Clear сохраняет вместимость, а уменьшающий Resize сжимает вектор по политике
+        Vector<int, std::allocator<int>, HysteresisShrink<DoublingGrowth>> v(64);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == 64);
+        v.Resize(64);
+        v.Resize(0);
+        assert(v.Capacity() < 64);
+    }
+    {
+        CountingAllocator<int>::Counters counters;
+        {
+            VectorPool<int, CountingAllocator<int>> pool(32, 2, 256, CountingAllocator<int>(&counters));
+            for (int request = 0; request < 10; ++request) {
+                auto lease = pool.Acquire();
+                assert(lease->Size() == 0 && lease->Capacity() >= 32);
+                for (int i = 0; i < 100; ++i) {
+                    lease->PushBack(i);
+                }
+                assert((*lease)[99] == 99);
+            }
+            // После первого запроса буфер нужного размера берётся из пула
+            assert(counters.allocations == 3 && counters.deallocations == 2);
+            assert(pool.Retained() == 1);
+
+            // Хранится не больше max_retained векторов
+            {
+                auto a = pool.Acquire();
+                auto b = pool.Acquire();
+                auto c = pool.Acquire();
+                auto moved = std::move(c);
+                assert(pool.Retained() == 0 && moved->Capacity() == 32);
+            }
+            assert(pool.Retained() == 2);
+
+            // Слишком большой вектор при возврате освобождается
+            int before = 0;
+            {
+                auto lease = pool.Acquire();
+                lease->Resize(1000);
+                before = counters.deallocations;
+            }
+            assert(pool.Retained() == 1 && counters.deallocations == before + 1);
+
+            // Вектор, созданный вне пула, сохраняется, если он не меньше initial_capacity
+            Vector<int, CountingAllocator<int>> small(3, CountingAllocator<int>(&counters));
+            pool.Release(std::move(small));
+            assert(pool.Retained() == 1);
+            Vector<int, CountingAllocator<int>> outside(64, CountingAllocator<int>(&counters));
+            pool.Release(std::move(outside));
+            assert(pool.Retained() == 2);
+            assert(pool.Acquire()->Capacity() == 64);
+            pool.Trim();
+            assert(pool.Retained() == 0);
+        }
+        assert(counters.allocations == counters.deallocations);
+    }
+}
+
+// Тривиально копируемый тип, конструктор которого может выбросить исключение
+struct CheckedId {
+    explicit CheckedId(int value)
+        : value(value) {
+        if (value < 0) {
+            throw std::invalid_argument("negative id");
+        }
+    }
+
+    int value;
+};
+
+int FortyTwo() {
+    return 42;
+}
+
+void Test35() {
+    using namespace std::literals;
+    {
+        // Вставка в середину: один перенос хвоста и одно создание элемента на месте
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(8);
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(i * 10);
+        }
+        const int num_moved = Obj::num_moved;
+        Obj& inserted = v.EmplaceAt(2, 15, "fifteen"s);
+        assert(&inserted == &v[2] && inserted.id == 15 && inserted.name == "fifteen");
+        assert(Obj::num_moved == num_moved + 3 && Obj::num_move_assigned == 0 && Obj::num_assigned == 0);
+        assert(Obj::num_constructed_with_id_and_name == 1 && Obj::GetAliveObjectCount() == 6);
+        assert(v[1].id == 10 && v[3].id == 20 && v[5].id == 40);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Аргументы-ссылки на сдвигаемые элементы и их подобъекты
+        Vector<std::string> v;
+        v.Reserve(8);
+        for (const char* name : {"a", "b", "c", "d"}) {
+            v.PushBack(name);
+        }
+        v.Insert(v.begin(), v[2]);
+        v.Emplace(v.begin() + 1, std::move(v[4]));
+        assert(v.Size() == 6 && v[0] == "c" && v[1] == "d" && v[2] == "a" && v[4] == "c" && v[5].empty());
+
+        Vector<Obj> objects;
+        objects.Reserve(4);
+        objects.EmplaceBack(1, "one"s);
+        objects.EmplaceBack(2, "two"s);
+        objects.Emplace(objects.begin(), objects[1].id, objects[1].name);
+        assert(objects[0].id == 2 && objects[0].name == "two" && objects[1].id == 1 && objects[2].id == 2);
+
+        Vector<int> ints{4};
+        std::iota(ints.begin(), ints.end(), 1);
+        ints.Reserve(8);
+        ints.Insert(ints.begin(), ints[3]);
+        ints.EmplaceAt(1, ints[4]);
+        assert(ints.Size() == 6 && ints[0] == 4 && ints[1] == 4 && ints[2] == 1 && ints[5] == 4);
+
+        // Рост через reallocate переносит весь буфер, поэтому ссылка на любой элемент сохраняет значение
+        Vector<int, MallocAllocator<int>> grown{3};
+        std::iota(grown.begin(), grown.end(), 7);
+        assert(grown.Capacity() == grown.Size());
+        grown.Insert(grown.begin() + 2, grown[0]);
+        assert(grown.Size() == 4 && grown[2] == 7 && grown[3] == 9);
+    }
+    {
+        // Если конструктор выбросил исключение, хвост возвращается на место
+        Vector<CheckedId> ids;
+        ids.Reserve(4);
+        ids.EmplaceBack(1);
+        ids.EmplaceBack(2);
+        try {
+            ids.EmplaceAt(0, -1);
+            assert(false);
+        } catch (const std::invalid_argument&) {
+        }
+        assert(ids.Size() == 2 && ids[0].value == 1 && ids[1].value == 2);
+
+        Obj::ResetCounters();
+        {
+            Vector<Obj> v;
+            v.Reserve(4);
+            v.EmplaceBack(1);
+            v.EmplaceBack(2);
+            Obj::default_construction_throw_countdown = 1;
+            try {
+                v.Emplace(v.begin());
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2 && v[0].id == 1 && v[1].id == 2 && Obj::GetAliveObjectCount() == 2);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // OpenGap: промежуток заполняется вызывающим кодом
+        Vector<int> v{5};
+        std::iota(v.begin(), v.end(), 0);
+        const Span<int> gap = v.OpenGap(v.begin() + 2, 3);
+        assert(gap.Size() == 3 && gap.Data() == v.begin() + 2 && v.Size() == 8);
+        std::fill(gap.begin(), gap.end(), -1);
+        const int expected[] = {0, 1, -1, -1, -1, 2, 3, 4};
+        assert(std::equal(v.begin(), v.end(), std::begin(expected), std::end(expected)));
+        v.Reserve(16);
+        const Span<int> inner = v.OpenGap(v.end() - 1, 2);
+        inner[0] = 8;
+        inner[1] = 9;
+        assert(v.Size() == 10 && v[7] == 8 && v[8] == 9 && v[9] == 4 && v.Capacity() == 16);
+
+        Vector<int, MallocAllocator<int>> grown{2};
+        grown[1] = 5;
+        grown.OpenGap(grown.begin() + 1, 2)[1] = 3;
+        assert(grown.Size() == 4 && grown[0] == 0 && grown[2] == 3 && grown[3] == 5);
+    }
+    {
+        // Ссылка на функцию в аргументах
+        Vector<std::function<int()>> callbacks;
+        callbacks.Reserve(2);
+        callbacks.EmplaceBack([] {
+            return 1;
+        });
+        callbacks.Emplace(callbacks.begin(), FortyTwo);
+        assert(callbacks[0]() == 42 && callbacks[1]() == 1);
+    }
+    {
+        // Исключение при копировании в новый буфер: созданный элемент и скопированная часть разрушаются,
+        // вектор не изменяется. Первым создаётся новый элемент, затем копируются старые
+        for (long throw_at : {2, 4}) {
+            Vector<ParallelObj> v(4);
+            SmallVector<ParallelObj, 4> small(4);
+            assert(v.Size() == v.Capacity() && small.Size() == small.Capacity());
+            for (int i = 0; i < 4; ++i) {
+                v[i].value = small[i].value = i;
+            }
+            ParallelObj::construction_throw_countdown = throw_at;
+            try {
+                v.Emplace(v.begin() + 2);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            ParallelObj::construction_throw_countdown = throw_at;
+            try {
+                v.EmplaceBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            ParallelObj::construction_throw_countdown = throw_at;
+            try {
+                v.PushBack(small[0]);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            ParallelObj::construction_throw_countdown = throw_at;
+            try {
+                small.Emplace(small.begin() + 2);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            ParallelObj::construction_throw_countdown = throw_at;
+            try {
+                small.EmplaceBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            ParallelObj::construction_throw_countdown = 0;
+            assert(ParallelObj::num_alive == 8 && v.Size() == 4 && v.Capacity() == 4 && small.Size() == 4);
+            assert(v[2].value == 2 && small[3].value == 3);
+        }
+        assert(ParallelObj::num_alive == 0);
+    }
+}
+
 struct C {
     C() noexcept {
         ++def_ctor;
@@ -647,6 +2890,35 @@ int main() {
         Test4();
         Test5();
         Test6();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
         Benchmark();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
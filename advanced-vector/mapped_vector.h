@@ -0,0 +1,312 @@
+#pragma once
+#include "vector.h"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Заголовок файла MappedVector. Числа хранятся в порядке байтов процессора, поэтому файл
+// переносим только между машинами с одинаковым порядком байтов
+struct MappedVectorHeader {
+    static constexpr uint64_t MAGIC = 0x4345'5650'414d'5641;  // "AVMAPVEC"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t element_size = 0;
+    uint64_t size = 0;
+    uint64_t capacity = 0;
+};
+
+// Вектор тривиально копируемых элементов, которые хранятся в файле, отображённом в память (Linux).
+// Открытие готового файла не копирует элементы: таблица, построенная в прошлом запуске, доступна сразу.
+// Файл растёт через ftruncate и mremap, изменения попадают в файл через страничный кэш, а Flush
+// дожидается их записи на диск (msync). В режиме READ_ONLY изменять вектор нельзя
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores elements as raw bytes");
+    static_assert(alignof(T) <= CACHE_LINE_SIZE, "elements must fit the data offset alignment");
+
+public:
+    enum class Access {
+        READ_WRITE,  // файл создаётся, если его нет
+        READ_ONLY,
+    };
+
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Элементы начинаются с кэш-линии, следующей за заголовком
+    static constexpr size_t DATA_OFFSET = CACHE_LINE_SIZE;
+    static_assert(sizeof(MappedVectorHeader) <= DATA_OFFSET);
+
+    // Выбрасывает std::system_error при ошибке ввода-вывода и std::runtime_error, если файл не является
+    // вектором элементов размера sizeof(T)
+    explicit MappedVector(const std::string& path, Access access = Access::READ_WRITE);
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+    MappedVector(MappedVector&& other) noexcept;
+    MappedVector& operator=(MappedVector&& rhs) noexcept;
+
+    ~MappedVector();
+
+    // Изменяемый доступ (итераторы, Span, operator[]) запрещён в режиме только для чтения:
+    // страницы отображены без PROT_WRITE. Для чтения используйте константный объект
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return Data()[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Size() && !IsReadOnly());
+        return Data()[index];
+    }
+
+    size_t Size() const noexcept {
+        return header_ != nullptr ? header_->size : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return header_ != nullptr ? header_->capacity : 0;
+    }
+
+    bool IsReadOnly() const noexcept {
+        return access_ == Access::READ_ONLY;
+    }
+
+    void Reserve(size_t new_capacity);
+    void Resize(size_t new_size);
+    void PushBack(const T& value);
+    void PopBack() noexcept;
+    void Swap(MappedVector& other) noexcept;
+
+    // Дожидается записи изменённых страниц в файл
+    void Flush();
+
+private:
+    int fd_ = -1;
+    Access access_ = Access::READ_WRITE;
+    MappedVectorHeader* header_ = nullptr;
+    size_t mapped_bytes_ = 0;
+
+    T* Data() const noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(header_) + DATA_OFFSET);
+    }
+
+    static size_t Bytes(size_t capacity) noexcept {
+        return DATA_OFFSET + capacity * sizeof(T);
+    }
+
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void Map(size_t bytes);
+    void Unmap() noexcept;
+};
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(const std::string& path, Access access)
+    : access_(access) //
+{
+    fd_ = ::open(path.c_str(), access == Access::READ_ONLY ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        ThrowSystemError("open");
+    }
+    try {
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) {
+            ThrowSystemError("fstat");
+        }
+        const size_t file_bytes = static_cast<size_t>(st.st_size);
+        if (file_bytes == 0 && access == Access::READ_WRITE) {
+            // Новый файл: заголовок пустого вектора
+            if (::ftruncate(fd_, static_cast<off_t>(Bytes(0))) != 0) {
+                ThrowSystemError("ftruncate");
+            }
+            Map(Bytes(0));
+            *header_ = MappedVectorHeader{};
+            header_->element_size = sizeof(T);
+            return;
+        }
+        if (file_bytes < sizeof(MappedVectorHeader)) {
+            throw std::runtime_error("MappedVector: file is too short");
+        }
+        Map(file_bytes);
+        const MappedVectorHeader& header = *header_;
+        if (header.magic != MappedVectorHeader::MAGIC || header.version != MappedVectorHeader::VERSION) {
+            throw std::runtime_error("MappedVector: not a vector file");
+        }
+        if (header.element_size != sizeof(T)) {
+            throw std::runtime_error("MappedVector: element size mismatch");
+        }
+        if (header.size > header.capacity || header.capacity > (file_bytes - DATA_OFFSET) / sizeof(T)) {
+            throw std::runtime_error("MappedVector: corrupted header");
+        }
+    } catch (...) {
+        Unmap();
+        ::close(fd_);
+        throw;
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(MappedVector&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1))
+    , access_(other.access_)
+    , header_(std::exchange(other.header_, nullptr))
+    , mapped_bytes_(std::exchange(other.mapped_bytes_, 0)) //
+{
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>& MappedVector<T, GrowthPolicy>::operator=(MappedVector&& rhs) noexcept {
+    if (this != &rhs) {
+        MappedVector moved(std::move(rhs));
+        Swap(moved);
+    }
+    return *this;
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::~MappedVector() {
+    Unmap();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::begin() noexcept {
+    assert(!IsReadOnly());
+    return header_ != nullptr ? Data() : nullptr;
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::end() noexcept {
+    return begin() + Size();
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::begin() const noexcept {
+    return header_ != nullptr ? Data() : nullptr;
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::end() const noexcept {
+    return begin() + Size();
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::cbegin() const noexcept {
+    return begin();
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::cend() const noexcept {
+    return end();
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Reserve(size_t new_capacity) {
+    assert(!IsReadOnly());
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    if (new_capacity > (SIZE_MAX - DATA_OFFSET) / sizeof(T)) {
+        throw std::length_error("MappedVector: capacity is too large");
+    }
+    const size_t new_bytes = Bytes(new_capacity);
+    if (::ftruncate(fd_, static_cast<off_t>(new_bytes)) != 0) {
+        ThrowSystemError("ftruncate");
+    }
+    void* remapped = ::mremap(static_cast<void*>(header_), mapped_bytes_, new_bytes, MREMAP_MAYMOVE);
+    if (remapped == MAP_FAILED) {
+        const int error = errno;
+        // Файл возвращается к прежней длине, отображение не изменилось
+        (void)::ftruncate(fd_, static_cast<off_t>(mapped_bytes_));
+        throw std::system_error(error, std::generic_category(), "mremap");
+    }
+    header_ = static_cast<MappedVectorHeader*>(remapped);
+    mapped_bytes_ = new_bytes;
+    header_->capacity = new_capacity;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Resize(size_t new_size) {
+    assert(!IsReadOnly());
+    Reserve(new_size);
+    if (new_size > Size()) {
+        std::uninitialized_value_construct_n(Data() + Size(), new_size - Size());
+    }
+    header_->size = new_size;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::PushBack(const T& value) {
+    assert(!IsReadOnly());
+    if (Size() == Capacity()) {
+        // value может лежать в отображении, которое mremap переместит
+        const T copy = value;
+        Reserve(GrowthPolicy::NextCapacity(Capacity(), Size() + 1, sizeof(T)));
+        Data()[Size()] = copy;
+    } else {
+        Data()[Size()] = value;
+    }
+    ++header_->size;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::PopBack() noexcept {
+    assert(!IsReadOnly());
+    if (Size() > 0) {
+        --header_->size;
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Swap(MappedVector& other) noexcept {
+    std::swap(fd_, other.fd_);
+    std::swap(access_, other.access_);
+    std::swap(header_, other.header_);
+    std::swap(mapped_bytes_, other.mapped_bytes_);
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Flush() {
+    if (header_ != nullptr && !IsReadOnly() && ::msync(static_cast<void*>(header_), mapped_bytes_, MS_SYNC) != 0) {
+        ThrowSystemError("msync");
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Map(size_t bytes) {
+    const int protection = IsReadOnly() ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* p = ::mmap(nullptr, bytes, protection, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) {
+        ThrowSystemError("mmap");
+    }
+    header_ = static_cast<MappedVectorHeader*>(p);
+    mapped_bytes_ = bytes;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Unmap() noexcept {
+    if (header_ != nullptr) {
+        ::munmap(static_cast<void*>(header_), mapped_bytes_);
+        header_ = nullptr;
+        mapped_bytes_ = 0;
+    }
+}
@@ -0,0 +1,224 @@
+#pragma once
+#include "vector.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Параметры размещения крупных буферов MmapAllocator
+struct MmapOptions {
+    enum class HugePages {
+        NONE,
+        TRANSPARENT,  // madvise(MADV_HUGEPAGE) для буфера, выровненного по огромной странице
+        EXPLICIT,     // MAP_HUGETLB из заранее зарезервированных страниц; без них — как TRANSPARENT
+    };
+    // Политика NUMA для страниц буфера (mbind)
+    enum class Numa {
+        DEFAULT,    // страница попадает на узел потока, который первым к ней обратился
+        PREFERRED,  // первый узел из node_mask, если на нём есть свободная память
+        BIND,       // только узлы из node_mask
+        INTERLEAVE, // страницы по очереди распределяются по узлам из node_mask
+    };
+
+    HugePages huge_pages = HugePages::TRANSPARENT;
+    Numa numa = Numa::DEFAULT;
+    // Узлы 0..63 для PREFERRED, BIND и INTERLEAVE
+    uint64_t node_mask = 0;
+    // Блоки меньше порога выделяются через operator new, от порога — отдельным отображением mmap
+    size_t threshold_bytes = HUGE_PAGE_SIZE;
+
+    bool operator==(const MmapOptions& other) const noexcept {
+        return huge_pages == other.huge_pages && numa == other.numa && node_mask == other.node_mask
+               && threshold_bytes == other.threshold_bytes;
+    }
+    bool operator!=(const MmapOptions& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+// Аллокатор для больших таблиц: блоки от MmapOptions::threshold_bytes отображаются через mmap
+// на огромных страницах и с заданной политикой NUMA, меньшие выделяет operator new.
+// Страницы отображения не заполняются при выделении, поэтому Vector(execution::par, size) создаёт
+// элементы в тех потоках, которые потом с ними работают, и при политике DEFAULT страницы попадают
+// на их узлы. reallocate расширяет отображение через mremap без копирования.
+// Вне Linux все блоки выделяет operator new
+template <typename T>
+class MmapAllocator {
+public:
+    using value_type = T;
+    // Параметры определяют, как был выделен блок, поэтому распространяются вместе с памятью
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    MmapAllocator() noexcept = default;
+
+    explicit MmapAllocator(const MmapOptions& options) noexcept
+        : options_(options) {
+    }
+
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U>& other) noexcept
+        : options_(other.GetOptions()) {
+    }
+
+    const MmapOptions& GetOptions() const noexcept {
+        return options_;
+    }
+
+    T* allocate(size_t n) {
+        const size_t bytes = Bytes(n);
+        if (!IsMapped(bytes)) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+        }
+        return static_cast<T*>(Map(MappedBytes(bytes)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (!IsMapped(bytes)) {
+            ::operator delete(static_cast<void*>(p), bytes, std::align_val_t{alignof(T)});
+            return;
+        }
+#if defined(__linux__)
+        ::munmap(static_cast<void*>(p), MappedBytes(bytes));
+#endif
+    }
+
+    // Отображение растёт или сжимается через mremap, остальные блоки копируются в новый.
+    // При ошибке выбрасывает std::bad_alloc, исходный блок остаётся действительным
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = Bytes(new_n);
+#if defined(__linux__)
+        if (p != nullptr && IsMapped(old_bytes) && IsMapped(new_bytes)) {
+            void* moved = ::mremap(static_cast<void*>(p), MappedBytes(old_bytes), MappedBytes(new_bytes), MREMAP_MAYMOVE);
+            if (moved != MAP_FAILED) {
+                return static_cast<T*>(moved);
+            }
+        }
+#endif
+        T* new_p = allocate(new_n);
+        if (p != nullptr) {
+            std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), std::min(old_bytes, new_bytes));
+            deallocate(p, old_n);
+        }
+        return new_p;
+    }
+
+    template <typename U>
+    bool operator==(const MmapAllocator<U>& other) const noexcept {
+        return options_ == other.GetOptions();
+    }
+    template <typename U>
+    bool operator!=(const MmapAllocator<U>& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    MmapOptions options_;
+
+    static size_t Bytes(size_t n) {
+        if (n > (SIZE_MAX - HUGE_PAGE_SIZE) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    bool IsMapped(size_t bytes) const noexcept {
+#if defined(__linux__)
+        return bytes != 0 && bytes >= options_.threshold_bytes;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    // Длина отображения зависит только от размера блока, поэтому munmap и mremap получают ту же длину,
+    // что и mmap, даже если MAP_HUGETLB не сработал и блок отображён обычными страницами
+    size_t MappedBytes(size_t bytes) const noexcept {
+        const size_t granularity = options_.huge_pages == MmapOptions::HugePages::NONE ? BASE_PAGE_SIZE : HUGE_PAGE_SIZE;
+        return (bytes + granularity - 1) / granularity * granularity;
+    }
+
+    void* Map(size_t length) const {
+#if defined(__linux__)
+        void* p = MAP_FAILED;
+        if (options_.huge_pages == MmapOptions::HugePages::EXPLICIT) {
+            p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+        if (p == MAP_FAILED && options_.huge_pages != MmapOptions::HugePages::NONE) {
+            p = MapAligned(length, HUGE_PAGE_SIZE);
+            if (p != MAP_FAILED) {
+                ::madvise(p, length, MADV_HUGEPAGE);
+            }
+        } else if (p == MAP_FAILED) {
+            p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        Bind(p, length);
+        return p;
+#else
+        (void)length;
+        throw std::bad_alloc();
+#endif
+    }
+
+#if defined(__linux__)
+    // Отображает length байт с началом, выровненным по alignment: лишние страницы в начале
+    // и в конце запаса снимаются munmap
+    static void* MapAligned(size_t length, size_t alignment) noexcept {
+        const size_t reserved = length + alignment;
+        void* p = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            return p;
+        }
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(p);
+        const uintptr_t aligned = (begin + alignment - 1) / alignment * alignment;
+        if (aligned != begin) {
+            ::munmap(p, aligned - begin);
+        }
+        const size_t tail = begin + reserved - (aligned + length);
+        if (tail != 0) {
+            ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Политика NUMA задаётся до первого обращения к страницам. Это подсказка размещения:
+    // если ядро собрано без NUMA или вызов запрещён, буфер остаётся с политикой по умолчанию
+    void Bind(void* p, size_t length) const noexcept {
+        // Значения MPOL_* из <linux/mempolicy.h>
+        static constexpr int MPOL_PREFERRED_MODE = 1;
+        static constexpr int MPOL_BIND_MODE = 2;
+        static constexpr int MPOL_INTERLEAVE_MODE = 3;
+        int mode = 0;
+        switch (options_.numa) {
+            case MmapOptions::Numa::DEFAULT:
+                return;
+            case MmapOptions::Numa::PREFERRED:
+                mode = MPOL_PREFERRED_MODE;
+                break;
+            case MmapOptions::Numa::BIND:
+                mode = MPOL_BIND_MODE;
+                break;
+            case MmapOptions::Numa::INTERLEAVE:
+                mode = MPOL_INTERLEAVE_MODE;
+                break;
+        }
+        const unsigned long node_mask = options_.node_mask;
+        // Ядро читает maxnode - 1 бит маски
+        ::syscall(SYS_mbind, p, length, mode, &node_mask, sizeof(node_mask) * 8 + 1, 0);
+    }
+#endif
+};
+
+// Вектор для больших таблиц: крупные буферы на огромных страницах, вместимость округляется
+// до целого числа огромных страниц
+template <typename T>
+using HugePageVector = Vector<T, MmapAllocator<T>, HugePageRounding<DoublingGrowth>>;
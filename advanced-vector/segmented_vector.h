@@ -0,0 +1,256 @@
+#pragma once
+#include "vector.h"
+
+namespace detail {
+
+// Блок по умолчанию занимает около 4 КБ, но вмещает не меньше 16 элементов
+template <typename T>
+constexpr size_t Default_Block_Size() noexcept {
+    size_t block_size = 1;
+    while (block_size < 16 || block_size * 2 * sizeof(T) <= BASE_PAGE_SIZE) {
+        block_size *= 2;
+    }
+    return block_size;
+}
+
+}  // namespace detail
+
+// Вектор из блоков по BlockSize элементов и таблицы указателей на них. При росте добавляется новый блок,
+// а элементы никогда не переносятся, поэтому указатели и ссылки на них, в том числе возвращённые
+// EmplaceBack, остаются действительными до удаления самого элемента. Стоимость EmplaceBack не зависит
+// от размера: кроме выделения блока она включает лишь редкое перевыделение таблицы, которая в BlockSize
+// раз короче вектора. BlockSize — степень двойки, поэтому operator[] сводится к сдвигу и маске
+template <typename T, size_t BlockSize = detail::Default_Block_Size<T>(), typename Allocator = std::allocator<T>>
+class SegmentedVector {
+    static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "block size must be a power of two");
+
+    using Block = RawMemory<T, Allocator>;
+    using BlockTable = Vector<Block, typename std::allocator_traits<Allocator>::template rebind_alloc<Block>>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    // Итераторы хранят индекс, поэтому добавление элементов их не портит
+    using iterator = detail::IndexIterator<SegmentedVector, false>;
+    using const_iterator = detail::IndexIterator<SegmentedVector, true>;
+
+    static constexpr size_t BLOCK_SIZE = BlockSize;
+
+    SegmentedVector() = default;
+    explicit SegmentedVector(const Allocator& alloc) noexcept;
+    explicit SegmentedVector(size_t size, const Allocator& alloc = Allocator());
+    SegmentedVector(const SegmentedVector& other);
+    SegmentedVector(SegmentedVector&& other) noexcept;
+
+    ~SegmentedVector();
+
+    SegmentedVector& operator=(const SegmentedVector& rhs);
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept;
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return blocks_[index / BlockSize][index % BlockSize];
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return blocks_.Size() * BlockSize;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Выделяет блоки, пока вместимость меньше new_capacity; элементы остаются на месте
+    void Reserve(size_t new_capacity);
+    void Swap(SegmentedVector& other) noexcept;
+    void Resize(size_t new_size);
+    void PushBack(const T& value);
+    void PushBack(T&& value);
+    void PopBack() noexcept;
+    // Разрушает элементы, блоки остаются выделенными
+    void Clear() noexcept;
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+private:
+    Allocator alloc_;
+    BlockTable blocks_;
+    size_t size_ = 0;
+
+    void Add_Block();
+};
+
+template <typename T, size_t BlockSize, typename Allocator>
+SegmentedVector<T, BlockSize, Allocator>::SegmentedVector(const Allocator& alloc) noexcept
+    : alloc_(alloc)
+    , blocks_(typename BlockTable::allocator_type(alloc)) //
+{
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+SegmentedVector<T, BlockSize, Allocator>::SegmentedVector(size_t size, const Allocator& alloc)
+    : SegmentedVector(alloc) //
+{
+    Resize(size);
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+SegmentedVector<T, BlockSize, Allocator>::SegmentedVector(const SegmentedVector& other)
+    : SegmentedVector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc_)) //
+{
+    // Основной конструктор уже отработал, поэтому при исключении деструктор разрушит скопированные элементы
+    Reserve(other.size_);
+    for (size_t i = 0; i < other.size_; ++i) {
+        EmplaceBack(other[i]);
+    }
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+SegmentedVector<T, BlockSize, Allocator>::SegmentedVector(SegmentedVector&& other) noexcept
+    : alloc_(other.alloc_)
+    , blocks_(std::move(other.blocks_))
+    , size_(std::exchange(other.size_, 0)) //
+{
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+SegmentedVector<T, BlockSize, Allocator>::~SegmentedVector() {
+    Clear();
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+SegmentedVector<T, BlockSize, Allocator>& SegmentedVector<T, BlockSize, Allocator>::operator=(const SegmentedVector& rhs) {
+    if (this != &rhs) {
+        /* Применить copy-and-swap */
+        SegmentedVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+SegmentedVector<T, BlockSize, Allocator>& SegmentedVector<T, BlockSize, Allocator>::operator=(SegmentedVector&& rhs) noexcept {
+    Swap(rhs);
+    return *this;
+}
+
+//Итераторы
+template <typename T, size_t BlockSize, typename Allocator>
+typename SegmentedVector<T, BlockSize, Allocator>::iterator SegmentedVector<T, BlockSize, Allocator>::begin() noexcept {
+    return iterator(this, 0);
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+typename SegmentedVector<T, BlockSize, Allocator>::iterator SegmentedVector<T, BlockSize, Allocator>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+typename SegmentedVector<T, BlockSize, Allocator>::const_iterator SegmentedVector<T, BlockSize, Allocator>::begin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+typename SegmentedVector<T, BlockSize, Allocator>::const_iterator SegmentedVector<T, BlockSize, Allocator>::end() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+typename SegmentedVector<T, BlockSize, Allocator>::const_iterator SegmentedVector<T, BlockSize, Allocator>::cbegin() const noexcept {
+    return begin();
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+typename SegmentedVector<T, BlockSize, Allocator>::const_iterator SegmentedVector<T, BlockSize, Allocator>::cend() const noexcept {
+    return end();
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::Reserve(size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    blocks_.Reserve((new_capacity + BlockSize - 1) / BlockSize);
+    while (Capacity() < new_capacity) {
+        Add_Block();
+    }
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::Swap(SegmentedVector& other) noexcept {
+    using std::swap;
+    swap(alloc_, other.alloc_);
+    blocks_.Swap(other.blocks_);
+    std::swap(size_, other.size_);
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::Resize(size_t new_size) {
+    if (new_size < size_) {
+        while (size_ > new_size) {
+            PopBack();
+        }
+        return;
+    }
+    Reserve(new_size);
+    while (size_ < new_size) {
+        EmplaceBack();
+    }
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::PushBack(const T& value) {
+    EmplaceBack(value);
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::PushBack(T&& value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::PopBack() noexcept {
+    assert(size_ > 0);
+    std::destroy_at(&(*this)[size_ - 1]);
+    --size_;
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::Clear() noexcept {
+    while (size_ > 0) {
+        PopBack();
+    }
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+template <typename... Args>
+T& SegmentedVector<T, BlockSize, Allocator>::EmplaceBack(Args&&... args) {
+    // Элементы не переносятся, поэтому args могут ссылаться на элементы самого вектора
+    if (size_ == Capacity()) {
+        Add_Block();
+    }
+    T* elem = new (blocks_[size_ / BlockSize] + size_ % BlockSize) T(std::forward<Args>(args)...);
+    ++size_;
+    return *elem;
+}
+
+template <typename T, size_t BlockSize, typename Allocator>
+void SegmentedVector<T, BlockSize, Allocator>::Add_Block() {
+    blocks_.EmplaceBack(BlockSize, alloc_);
+}
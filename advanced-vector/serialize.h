@@ -0,0 +1,307 @@
+#pragma once
+#include "vector.h"
+
+#include <cerrno>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <system_error>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Двоичный формат Vector: заголовок SerializedHeader и сразу за ним элементы. Тривиально копируемые
+// элементы записываются одним непрерывным блоком байтов буфера Vector, остальные — по одному через
+// Serializer<T>. Числа хранятся в порядке байтов процессора
+struct SerializedHeader {
+    static constexpr uint32_t MAGIC = 0x5653'5641;  // "AVSV"
+    static constexpr uint16_t VERSION = 1;
+
+    uint32_t magic = MAGIC;
+    uint16_t version = VERSION;
+    // sizeof(T) для побайтовой записи, 0 — элементы записаны Serializer<T>
+    uint16_t element_size = 0;
+    uint64_t size = 0;
+};
+
+// Точка настройки для типов, которые нельзя передавать побайтово. Специализация определяет
+//     template <typename Sink> static void Write(Sink& sink, const T& value);
+//     template <typename Source> static T Read(Source& source);
+// где sink.Write(const void* data, size_t size) записывает байты, а source.Read(void* data, size_t size)
+// читает ровно size байт или выбрасывает исключение
+template <typename T>
+struct Serializer;
+
+template <>
+struct Serializer<std::string> {
+    template <typename Sink>
+    static void Write(Sink& sink, const std::string& value) {
+        const uint64_t size = value.size();
+        sink.Write(&size, sizeof(size));
+        sink.Write(value.data(), value.size());
+    }
+
+    template <typename Source>
+    static std::string Read(Source& source) {
+        uint64_t size = 0;
+        source.Read(&size, sizeof(size));
+        std::string value;
+        // Строка растёт по мере чтения, поэтому испорченная длина не приводит к огромному выделению
+        constexpr size_t CHUNK = 64 * 1024;
+        while (value.size() < size) {
+            const size_t offset = value.size();
+            const size_t chunk = std::min<uint64_t>(CHUNK, size - offset);
+            value.resize(offset + chunk);
+            source.Read(value.data() + offset, chunk);
+        }
+        return value;
+    }
+};
+
+// Файловый дескриптор, в который или из которого передаётся вектор
+struct FileDescriptor {
+    int fd = -1;
+};
+
+namespace detail {
+
+template <typename T>
+inline constexpr bool is_serialized_as_bytes_v = std::is_trivially_copyable_v<T>;
+
+template <typename T>
+SerializedHeader Make_Header(size_t size) {
+    SerializedHeader header;
+    if constexpr (is_serialized_as_bytes_v<T>) {
+        static_assert(sizeof(T) <= UINT16_MAX, "element is too large for the serialized header");
+        header.element_size = sizeof(T);
+    }
+    header.size = size;
+    return header;
+}
+
+template <typename T>
+void Check_Header(const SerializedHeader& header) {
+    if (header.magic != SerializedHeader::MAGIC || header.version != SerializedHeader::VERSION) {
+        throw std::runtime_error("Deserialize: not a serialized vector");
+    }
+    if (header.element_size != Make_Header<T>(0).element_size) {
+        throw std::runtime_error("Deserialize: element type mismatch");
+    }
+}
+
+struct StreamSink {
+    std::ostream& out;
+
+    void Write(const void* data, size_t size) {
+        if (!out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Serialize: stream write failed");
+        }
+    }
+};
+
+struct BufferSink {
+    Vector<char>& buffer;
+
+    void Write(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer.Append(bytes, bytes + size);
+    }
+};
+
+struct StreamSource {
+    std::istream& in;
+
+    void Read(void* data, size_t size) {
+        if (!in.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Deserialize: unexpected end of stream");
+        }
+    }
+};
+
+struct BufferSource {
+    ConstSpan<char> buffer;
+    size_t offset = 0;
+
+    void Read(void* data, size_t size) {
+        if (size > buffer.Size() - offset) {
+            throw std::runtime_error("Deserialize: unexpected end of buffer");
+        }
+        std::memcpy(data, buffer.Data() + offset, size);
+        offset += size;
+    }
+};
+
+struct FdSource {
+    int fd;
+
+    void Read(void* data, size_t size) {
+        char* dst = static_cast<char*>(data);
+        while (size != 0) {
+            const ssize_t n = ::read(fd, dst, size);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+            if (n == 0) {
+                throw std::runtime_error("Deserialize: unexpected end of file");
+            }
+            dst += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+};
+
+// Записывает все байты из iov, продолжая после частичных записей
+inline void Write_All(int fd, iovec* iov, int count) {
+    while (count > 0) {
+        const ssize_t n = ::writev(fd, iov, count);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        size_t written = static_cast<size_t>(n);
+        while (count > 0 && written >= iov->iov_len) {
+            written -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+template <typename T, typename Sink>
+void Write_Elements(Sink& sink, const T* data, size_t size) {
+    if constexpr (is_serialized_as_bytes_v<T>) {
+        sink.Write(data, size * sizeof(T));
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            Serializer<T>::Write(sink, data[i]);
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename Source>
+Vector<T, Allocator> Read_Vector(Source& source, const Allocator& alloc) {
+    SerializedHeader header;
+    source.Read(&header, sizeof(header));
+    Check_Header<T>(header);
+    Vector<T, Allocator> result(alloc);
+    if constexpr (is_serialized_as_bytes_v<T>) {
+        // Буфер растёт по мере чтения, поэтому испорченный размер не приводит к огромному выделению
+        constexpr size_t CHUNK = std::max<size_t>(1, 1024 * 1024 / sizeof(T));
+        for (uint64_t remaining = header.size; remaining != 0;) {
+            const size_t count = std::min<uint64_t>(remaining, CHUNK);
+            const Span<T> chunk = result.AppendUninitialized(count);
+            source.Read(chunk.Data(), count * sizeof(T));
+            remaining -= count;
+        }
+    } else {
+        for (uint64_t i = 0; i < header.size; ++i) {
+            result.PushBack(Serializer<T>::Read(source));
+        }
+    }
+    return result;
+}
+
+}  // namespace detail
+
+// Записывает элементы представления в том же формате, что и вектор: часть вектора или чужой массив
+// сериализуется без промежуточной копии
+template <typename T>
+void Serialize(ConstSpan<T> values, std::ostream& out) {
+    detail::StreamSink sink{out};
+    const SerializedHeader header = detail::Make_Header<T>(values.Size());
+    sink.Write(&header, sizeof(header));
+    detail::Write_Elements(sink, values.Data(), values.Size());
+}
+
+// Дописывает элементы в конец buffer
+template <typename T>
+void Serialize(ConstSpan<T> values, Vector<char>& buffer) {
+    detail::BufferSink sink{buffer};
+    const SerializedHeader header = detail::Make_Header<T>(values.Size());
+    sink.Write(&header, sizeof(header));
+    detail::Write_Elements(sink, values.Data(), values.Size());
+}
+
+// Тривиально копируемые элементы записываются одним writev вместе с заголовком прямо из памяти
+// элементов, остальные сначала собираются в промежуточный буфер
+template <typename T>
+void Serialize(ConstSpan<T> values, FileDescriptor file) {
+    SerializedHeader header = detail::Make_Header<T>(values.Size());
+    if constexpr (detail::is_serialized_as_bytes_v<T>) {
+        iovec iov[2] = {{&header, sizeof(header)},
+                        {const_cast<T*>(values.Data()), values.Size() * sizeof(T)}};
+        detail::Write_All(file.fd, iov, 2);
+    } else {
+        Vector<char> buffer;
+        Serialize(values, buffer);
+        iovec iov[1] = {{buffer.begin(), buffer.Size()}};
+        detail::Write_All(file.fd, iov, 1);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Serialize(const Vector<T, Allocator, GrowthPolicy>& v, std::ostream& out) {
+    Serialize(ConstSpan<T>(v), out);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Serialize(const Vector<T, Allocator, GrowthPolicy>& v, Vector<char>& buffer) {
+    Serialize(ConstSpan<T>(v), buffer);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Serialize(const Vector<T, Allocator, GrowthPolicy>& v, FileDescriptor file) {
+    Serialize(ConstSpan<T>(v), file);
+}
+
+template <typename T, typename Allocator = std::allocator<T>>
+Vector<T, Allocator> Deserialize(std::istream& in, const Allocator& alloc = Allocator()) {
+    detail::StreamSource source{in};
+    return detail::Read_Vector<T>(source, alloc);
+}
+
+template <typename T, typename Allocator = std::allocator<T>>
+Vector<T, Allocator> Deserialize(FileDescriptor file, const Allocator& alloc = Allocator()) {
+    detail::FdSource source{file.fd};
+    return detail::Read_Vector<T>(source, alloc);
+}
+
+// Читает вектор из начала buffer; если consumed не nullptr, в него записывается число прочитанных байт
+template <typename T, typename Allocator = std::allocator<T>>
+Vector<T, Allocator> Deserialize(ConstSpan<char> buffer, size_t* consumed = nullptr, const Allocator& alloc = Allocator()) {
+    detail::BufferSource source{buffer};
+    Vector<T, Allocator> result = detail::Read_Vector<T>(source, alloc);
+    if (consumed != nullptr) {
+        *consumed = source.offset;
+    }
+    return result;
+}
+
+// Элементы вектора, записанного Serialize, прямо в принятом буфере (например, в кадре из сети)
+// без копирования. Буфером по-прежнему владеет вызывающий, он должен жить, пока используется
+// представление. Начало buffer должно быть выровнено по alignof(T)
+template <typename T>
+ConstSpan<T> DeserializeView(ConstSpan<char> buffer) {
+    static_assert(detail::is_serialized_as_bytes_v<T>, "only trivially copyable elements can be viewed in place");
+    detail::BufferSource source{buffer};
+    SerializedHeader header;
+    source.Read(&header, sizeof(header));
+    detail::Check_Header<T>(header);
+    const char* data = buffer.Data() + sizeof(header);
+    if (header.size > (buffer.Size() - sizeof(header)) / sizeof(T)) {
+        throw std::runtime_error("Deserialize: unexpected end of buffer");
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0) {
+        throw std::runtime_error("DeserializeView: buffer is not aligned for the element type");
+    }
+    return ConstSpan<T>(reinterpret_cast<const T*>(data), static_cast<size_t>(header.size));
+}
@@ -0,0 +1,491 @@
+#pragma once
+#include "span.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+// Векторизованные алгоритмы над непрерывными диапазонами арифметических элементов: Vector,
+// SmallVector, Span или любым контейнером, у которого begin() — указатель или есть data().
+// Ядра написаны на векторных расширениях GCC и компилируются для нескольких наборов инструкций
+// (AVX-512, AVX2, SSE2 на x86-64, NEON на AArch64); подходящий выбирается один раз во время
+// выполнения. Без векторных расширений используются скалярные циклы
+namespace simd {
+
+// Набор инструкций, под который собраны выполняемые ядра
+enum class Isa {
+    SCALAR,
+    VECTOR_128,  // SSE2 на x86-64 или NEON на AArch64
+    AVX2,
+    AVX512,
+};
+
+namespace detail {
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ADVANCED_VECTOR_SIMD_X86 1
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+#define ADVANCED_VECTOR_SIMD_VECTOR_128 1
+#endif
+
+#if defined(__GNUC__)
+#define ADVANCED_VECTOR_SIMD_INLINE inline __attribute__((always_inline))
+// Весь код ядра, включая пользовательскую операцию, встраивается в функцию с нужным набором
+// инструкций, поэтому векторные значения не передаются через границу функций
+#define ADVANCED_VECTOR_SIMD_TARGET(ISA) __attribute__((target(ISA), flatten))
+#define ADVANCED_VECTOR_SIMD_FLATTEN __attribute__((flatten))
+#else
+#define ADVANCED_VECTOR_SIMD_INLINE inline
+#define ADVANCED_VECTOR_SIMD_FLATTEN
+#endif
+
+// Элементы, которые умеют обрабатывать ядра
+template <typename T>
+inline constexpr bool is_simd_element_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>
+                                          && !std::is_same_v<T, long double> && sizeof(T) <= 8;
+
+#if defined(__GNUC__)
+template <typename T, size_t Width>
+struct VecOf {
+    typedef T type __attribute__((vector_size(Width)));
+};
+#else
+template <typename T, size_t Width>
+struct VecOf {
+    struct type {};
+};
+#endif
+
+// Вектор из Width / sizeof(T) элементов T
+template <typename T, size_t Width>
+using Vec = typename VecOf<T, Width>::type;
+
+// Элементы вектора V
+template <typename V>
+using LaneOf = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<V>()[0])>>;
+
+// Чтение и запись без требований к выравниванию: memcpy превращается в одну невыровненную загрузку.
+// Векторы передаются только по ссылке: векторные параметры и результаты функций, собранных
+// без AVX, меняют ABI, и GCC предупреждает об этом даже для встраиваемых функций
+template <typename V, typename T>
+ADVANCED_VECTOR_SIMD_INLINE void Load(V& v, const T* src) noexcept {
+    std::memcpy(&v, src, sizeof(V));
+}
+
+template <typename V, typename T>
+ADVANCED_VECTOR_SIMD_INLINE void Store(T* dst, const V& v) noexcept {
+    std::memcpy(dst, &v, sizeof(V));
+}
+
+// Есть ли в маске сравнения хотя бы один ненулевой элемент
+template <typename M>
+ADVANCED_VECTOR_SIMD_INLINE bool Any(const M& mask) noexcept {
+    constexpr size_t WORDS = sizeof(M) / sizeof(uint64_t);
+    uint64_t words[WORDS];
+    std::memcpy(words, &mask, sizeof(M));
+    uint64_t acc = 0;
+    for (size_t i = 0; i < WORDS; ++i) {
+        acc |= words[i];
+    }
+    return acc != 0;
+}
+
+// Тип суммы: целые суммируются в 64 бита, вещественные — в своём типе
+template <typename T>
+using SumType = std::conditional_t<std::is_floating_point_v<T>, T,
+                                   std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+// Каждое ядро — класс со статическим шаблоном Run<Width>: Width — ширина вектора в байтах,
+// 0 — скалярный цикл. Хвост, не заполняющий целый вектор, всегда обрабатывается скалярно
+struct FillKernel {
+    template <size_t Width, typename T>
+    ADVANCED_VECTOR_SIMD_INLINE static void Run(T* data, size_t size, T value) {
+        size_t i = 0;
+        if constexpr (Width != 0) {
+            using V = Vec<T, Width>;
+            constexpr size_t LANES = Width / sizeof(T);
+            const V v = V{} + value;
+            for (; i + LANES <= size; i += LANES) {
+                Store(data + i, v);
+            }
+        }
+        for (; i < size; ++i) {
+            data[i] = value;
+        }
+    }
+};
+
+struct FindKernel {
+    template <size_t Width, typename T>
+    ADVANCED_VECTOR_SIMD_INLINE static size_t Run(const T* data, size_t size, T value) {
+        size_t i = 0;
+        if constexpr (Width != 0) {
+            using V = Vec<T, Width>;
+            constexpr size_t LANES = Width / sizeof(T);
+            const V v = V{} + value;
+            for (; i + LANES <= size; i += LANES) {
+                V block;
+                Load(block, data + i);
+                if (Any(block == v)) {
+                    break;
+                }
+            }
+        }
+        for (; i < size && !(data[i] == value); ++i) {
+        }
+        return i;
+    }
+};
+
+struct CountKernel {
+    template <size_t Width, typename T>
+    ADVANCED_VECTOR_SIMD_INLINE static size_t Run(const T* data, size_t size, T value) {
+        size_t count = 0;
+        size_t i = 0;
+        if constexpr (Width != 0) {
+            using V = Vec<T, Width>;
+            using Mask = decltype(V{} == V{});
+            using Counter = Vec<std::make_unsigned_t<LaneOf<Mask>>, Width>;
+            constexpr size_t LANES = Width / sizeof(T);
+            // Счётчики в элементах маски не должны переполниться до сброса в count
+            constexpr size_t MAX_BLOCKS = sizeof(T) < sizeof(size_t) ? (size_t{1} << (8 * sizeof(T))) - 1
+                                                                     : std::numeric_limits<size_t>::max();
+            const V v = V{} + value;
+            while (i + LANES <= size) {
+                const size_t blocks = std::min(MAX_BLOCKS, (size - i) / LANES);
+                Counter counter{};
+                for (size_t b = 0; b < blocks; ++b, i += LANES) {
+                    // Совпавшие элементы маски равны -1
+                    V block;
+                    Load(block, data + i);
+                    counter -= reinterpret_cast<Counter>(block == v);
+                }
+                for (size_t lane = 0; lane < LANES; ++lane) {
+                    count += counter[lane];
+                }
+            }
+        }
+        for (; i < size; ++i) {
+            count += data[i] == value;
+        }
+        return count;
+    }
+};
+
+struct SumKernel {
+    template <size_t Width, typename T>
+    ADVANCED_VECTOR_SIMD_INLINE static SumType<T> Run(const T* data, size_t size) {
+        using Acc = SumType<T>;
+        Acc sum = 0;
+        size_t i = 0;
+        if constexpr (Width != 0) {
+            constexpr size_t LANES = Width / sizeof(T);
+            if constexpr (std::is_integral_v<T> && sizeof(T) <= 2) {
+                // Вектор узких целых читается как вектор целых двойной ширины, каждый элемент
+                // которого раскладывается на два исходных сдвигами. Частичные суммы сбрасываются
+                // в sum раньше, чем переполнятся: преобразование типов элементов вектора GCC
+                // выполняет поэлементно, а сдвиги — одной инструкцией
+                constexpr unsigned BITS = 8 * sizeof(T);
+                using Wide = std::conditional_t<sizeof(T) == 1, int16_t, int32_t>;
+                using Lane = std::conditional_t<std::is_signed_v<T>, Wide, std::make_unsigned_t<Wide>>;
+                using AccV = Vec<Lane, Width>;
+                constexpr size_t MAX_BLOCKS = (size_t{1} << (BITS - 1)) - 1;
+                while (i + LANES <= size) {
+                    const size_t blocks = std::min(MAX_BLOCKS, (size - i) / LANES);
+                    AccV acc{};
+                    for (size_t b = 0; b < blocks; ++b, i += LANES) {
+                        AccV block;
+                        Load(block, data + i);
+                        acc += ((block << BITS) >> BITS) + (block >> BITS);
+                    }
+                    for (size_t lane = 0; lane < Width / sizeof(Lane); ++lane) {
+                        sum += acc[lane];
+                    }
+                }
+            } else {
+                using V = Vec<T, Width>;
+                V acc{};
+                for (; i + LANES <= size; i += LANES) {
+                    V block;
+                    Load(block, data + i);
+                    acc += block;
+                }
+                for (size_t lane = 0; lane < LANES; ++lane) {
+                    sum += acc[lane];
+                }
+            }
+        }
+        for (; i < size; ++i) {
+            sum += data[i];
+        }
+        return sum;
+    }
+};
+
+struct MinMaxKernel {
+    template <size_t Width, typename T>
+    ADVANCED_VECTOR_SIMD_INLINE static std::pair<T, T> Run(const T* data, size_t size) {
+        T min = data[0];
+        T max = data[0];
+        size_t i = 0;
+        if constexpr (Width != 0) {
+            using V = Vec<T, Width>;
+            constexpr size_t LANES = Width / sizeof(T);
+            if (size >= LANES) {
+                V vmin;
+                Load(vmin, data);
+                V vmax = vmin;
+                for (i = LANES; i + LANES <= size; i += LANES) {
+                    V v;
+                    Load(v, data + i);
+                    vmin = v < vmin ? v : vmin;
+                    vmax = vmax < v ? v : vmax;
+                }
+                for (size_t lane = 0; lane < LANES; ++lane) {
+                    min = vmin[lane] < min ? vmin[lane] : min;
+                    max = max < vmax[lane] ? vmax[lane] : max;
+                }
+            }
+        }
+        for (; i < size; ++i) {
+            min = data[i] < min ? data[i] : min;
+            max = max < data[i] ? data[i] : max;
+        }
+        return {min, max};
+    }
+};
+
+// Пользовательские операции применяются к отдельным элементам: элементы копируются блоками
+// постоянной длины в локальные массивы, которые не пересекаются с диапазонами, и такой цикл
+// компилятор векторизует под набор инструкций функции, в которую встроено ядро
+struct TransformKernel {
+    template <size_t Width, typename T, typename U, typename UnaryOp>
+    ADVANCED_VECTOR_SIMD_INLINE static void Run(const T* src, size_t size, U* dst, UnaryOp op) {
+        size_t i = 0;
+        if constexpr (Width != 0) {
+            constexpr size_t LANES = Width / sizeof(T);
+            for (; i + LANES <= size; i += LANES) {
+                T in[LANES];
+                U out[LANES];
+                std::memcpy(in, src + i, sizeof(in));
+                for (size_t lane = 0; lane < LANES; ++lane) {
+                    out[lane] = static_cast<U>(op(in[lane]));
+                }
+                std::memcpy(dst + i, out, sizeof(out));
+            }
+        }
+        for (; i < size; ++i) {
+            dst[i] = static_cast<U>(op(src[i]));
+        }
+    }
+};
+
+struct BinaryTransformKernel {
+    template <size_t Width, typename T, typename U, typename BinaryOp>
+    ADVANCED_VECTOR_SIMD_INLINE static void Run(const T* lhs, const T* rhs, size_t size, U* dst, BinaryOp op) {
+        size_t i = 0;
+        if constexpr (Width != 0) {
+            constexpr size_t LANES = Width / sizeof(T);
+            for (; i + LANES <= size; i += LANES) {
+                T in_lhs[LANES];
+                T in_rhs[LANES];
+                U out[LANES];
+                std::memcpy(in_lhs, lhs + i, sizeof(in_lhs));
+                std::memcpy(in_rhs, rhs + i, sizeof(in_rhs));
+                for (size_t lane = 0; lane < LANES; ++lane) {
+                    out[lane] = static_cast<U>(op(in_lhs[lane], in_rhs[lane]));
+                }
+                std::memcpy(dst + i, out, sizeof(out));
+            }
+        }
+        for (; i < size; ++i) {
+            dst[i] = static_cast<U>(op(lhs[i], rhs[i]));
+        }
+    }
+};
+
+struct CompareKernel {
+    template <size_t Width, typename T, typename Predicate>
+    ADVANCED_VECTOR_SIMD_INLINE static void Run(const T* lhs, const T* rhs, size_t size, uint8_t* mask, Predicate pred) {
+        BinaryTransformKernel::Run<Width>(lhs, rhs, size, mask, [&pred](T a, T b) -> uint8_t {
+            return pred(a, b) ? 1 : 0;
+        });
+    }
+};
+
+#if defined(ADVANCED_VECTOR_SIMD_X86)
+template <typename Kernel, typename... Args>
+ADVANCED_VECTOR_SIMD_TARGET("avx512f,avx512bw,avx512dq,avx512vl") auto Run_Avx512(Args... args) {
+    return Kernel::template Run<64>(args...);
+}
+
+template <typename Kernel, typename... Args>
+ADVANCED_VECTOR_SIMD_TARGET("avx2") auto Run_Avx2(Args... args) {
+    return Kernel::template Run<32>(args...);
+}
+#endif
+
+#if defined(ADVANCED_VECTOR_SIMD_VECTOR_128)
+template <typename Kernel, typename... Args>
+ADVANCED_VECTOR_SIMD_FLATTEN auto Run_Vector128(Args... args) {
+    return Kernel::template Run<16>(args...);
+}
+#endif
+
+template <typename Kernel, typename... Args>
+ADVANCED_VECTOR_SIMD_FLATTEN auto Run_Scalar(Args... args) {
+    return Kernel::template Run<0>(args...);
+}
+
+inline Isa Detect_Isa() noexcept {
+#if defined(ADVANCED_VECTOR_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")
+        && __builtin_cpu_supports("avx512vl")) {
+        return Isa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::AVX2;
+    }
+    return Isa::VECTOR_128;
+#elif defined(ADVANCED_VECTOR_SIMD_VECTOR_128)
+    return Isa::VECTOR_128;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+// Запускает ядро, собранное под набор инструкций isa; isa не может быть шире поддерживаемого процессором
+template <typename Kernel, typename... Args>
+auto Dispatch(Isa isa, Args... args) {
+    switch (isa) {
+#if defined(ADVANCED_VECTOR_SIMD_X86)
+        case Isa::AVX512:
+            return Run_Avx512<Kernel>(args...);
+        case Isa::AVX2:
+            return Run_Avx2<Kernel>(args...);
+#endif
+#if defined(ADVANCED_VECTOR_SIMD_VECTOR_128)
+        case Isa::VECTOR_128:
+            return Run_Vector128<Kernel>(args...);
+#endif
+        default:
+            return Run_Scalar<Kernel>(args...);
+    }
+}
+
+template <typename Range>
+auto Data(Range& range) noexcept {
+    if constexpr (std::is_pointer_v<decltype(std::begin(range))>) {
+        return std::begin(range);
+    } else {
+        return std::data(range);
+    }
+}
+
+template <typename Range>
+size_t Size(Range& range) noexcept {
+    return static_cast<size_t>(std::end(range) - std::begin(range));
+}
+
+template <typename Range>
+using ElementOf = std::remove_cv_t<std::remove_pointer_t<decltype(Data(std::declval<Range&>()))>>;
+
+template <typename Range>
+inline constexpr bool is_simd_range_v = is_simd_element_v<ElementOf<Range>>;
+
+}  // namespace detail
+
+// Набор инструкций, выбранный для текущего процессора
+inline Isa CurrentIsa() noexcept {
+    static const Isa isa = detail::Detect_Isa();
+    return isa;
+}
+
+// Присваивает всем элементам диапазона значение value
+template <typename Range>
+void Fill(Range&& range, detail::ElementOf<Range> value) {
+    static_assert(detail::is_simd_range_v<Range>, "SIMD algorithms require arithmetic elements");
+    detail::Dispatch<detail::FillKernel>(CurrentIsa(), detail::Data(range), detail::Size(range), value);
+}
+
+// Указатель на первый элемент, равный value, или end(), если такого нет
+template <typename Range>
+auto Find(Range&& range, detail::ElementOf<Range> value) {
+    static_assert(detail::is_simd_range_v<Range>, "SIMD algorithms require arithmetic elements");
+    const auto data = detail::Data(range);
+    return data + detail::Dispatch<detail::FindKernel>(CurrentIsa(), static_cast<const detail::ElementOf<Range>*>(data),
+                                                       detail::Size(range), value);
+}
+
+template <typename Range>
+bool Contains(const Range& range, detail::ElementOf<Range> value) {
+    return Find(range, value) != detail::Data(range) + detail::Size(range);
+}
+
+// Количество элементов, равных value
+template <typename Range>
+size_t Count(const Range& range, detail::ElementOf<Range> value) {
+    static_assert(detail::is_simd_range_v<Range>, "SIMD algorithms require arithmetic elements");
+    return detail::Dispatch<detail::CountKernel>(CurrentIsa(), detail::Data(range), detail::Size(range), value);
+}
+
+// Сумма элементов: целые суммируются в int64_t/uint64_t, вещественные — в своём типе.
+// Порядок сложения вещественных отличается от последовательного, поэтому результат может
+// отличаться от std::accumulate в пределах погрешности округления
+template <typename Range>
+detail::SumType<detail::ElementOf<Range>> Sum(const Range& range) {
+    static_assert(detail::is_simd_range_v<Range>, "SIMD algorithms require arithmetic elements");
+    return detail::Dispatch<detail::SumKernel>(CurrentIsa(), detail::Data(range), detail::Size(range));
+}
+
+// Наименьший и наибольший элементы непустого диапазона. Для диапазонов с NaN результат не определён
+template <typename Range>
+std::pair<detail::ElementOf<Range>, detail::ElementOf<Range>> MinMax(const Range& range) {
+    static_assert(detail::is_simd_range_v<Range>, "SIMD algorithms require arithmetic elements");
+    assert(detail::Size(range) != 0);
+    return detail::Dispatch<detail::MinMaxKernel>(CurrentIsa(), detail::Data(range), detail::Size(range));
+}
+
+// dst[i] = op(src[i]). op должен быть доступен для встраивания (лямбда или функтор), иначе цикл
+// не векторизуется. dst может совпадать с src, но не перекрываться с ним частично
+template <typename SrcRange, typename DstRange, typename UnaryOp>
+void Transform(const SrcRange& src, DstRange&& dst, UnaryOp op) {
+    static_assert(detail::is_simd_range_v<SrcRange> && detail::is_simd_range_v<DstRange>,
+                  "SIMD algorithms require arithmetic elements");
+    assert(detail::Size(src) == detail::Size(dst));
+    detail::Dispatch<detail::TransformKernel>(CurrentIsa(), detail::Data(src), detail::Size(src), detail::Data(dst), op);
+}
+
+// dst[i] = op(lhs[i], rhs[i]), требования к op и dst те же, что у Transform с одним диапазоном
+template <typename LhsRange, typename RhsRange, typename DstRange, typename BinaryOp>
+void Transform(const LhsRange& lhs, const RhsRange& rhs, DstRange&& dst, BinaryOp op) {
+    static_assert(std::is_same_v<detail::ElementOf<LhsRange>, detail::ElementOf<RhsRange>>,
+                  "Transform requires ranges of the same element type");
+    static_assert(detail::is_simd_range_v<LhsRange> && detail::is_simd_range_v<DstRange>,
+                  "SIMD algorithms require arithmetic elements");
+    assert(detail::Size(lhs) == detail::Size(rhs) && detail::Size(lhs) == detail::Size(dst));
+    detail::Dispatch<detail::BinaryTransformKernel>(CurrentIsa(), detail::Data(lhs), detail::Data(rhs),
+                                                    detail::Size(lhs), detail::Data(dst), op);
+}
+
+// mask[i] = pred(lhs[i], rhs[i]) ? 1 : 0
+template <typename LhsRange, typename RhsRange, typename MaskRange, typename Predicate>
+void Compare(const LhsRange& lhs, const RhsRange& rhs, MaskRange&& mask, Predicate pred) {
+    static_assert(std::is_same_v<detail::ElementOf<LhsRange>, detail::ElementOf<RhsRange>>,
+                  "Compare requires ranges of the same element type");
+    static_assert(detail::is_simd_range_v<LhsRange>, "SIMD algorithms require arithmetic elements");
+    static_assert(std::is_same_v<detail::ElementOf<MaskRange>, uint8_t>, "Compare writes a mask of uint8_t");
+    assert(detail::Size(lhs) == detail::Size(rhs) && detail::Size(lhs) == detail::Size(mask));
+    detail::Dispatch<detail::CompareKernel>(CurrentIsa(), detail::Data(lhs), detail::Data(rhs), detail::Size(lhs),
+                                            detail::Data(mask), pred);
+}
+
+}  // namespace simd
@@ -0,0 +1,384 @@
+#pragma once
+#include "vector.h"
+
+// Вектор со встроенным буфером на N элементов. Пока элементов не больше N, они хранятся внутри
+// самого объекта и память в куче не выделяется. При переполнении элементы переносятся
+// в буфер RawMemory, выделенный аллокатором, и дальше вектор растёт как Vector
+template <typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+    static_assert(N > 0, "inline capacity must be positive");
+
+public:
+    using allocator_type = Allocator;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+    explicit SmallVector(const Allocator& alloc) noexcept;
+    explicit SmallVector(size_t size, const Allocator& alloc = Allocator());
+    SmallVector(const SmallVector& other);
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    ~SmallVector();
+
+    SmallVector& operator=(const SmallVector& rhs);
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Элементы хранятся во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return heap_.GetAllocator();
+    }
+
+    void Reserve(size_t new_capacity);
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+    void Resize(size_t new_size);
+    void PushBack(const T& value);
+    void PushBack(T&& value);
+    void PopBack() /* noexcept */;
+    // Разрушает элементы; буфер в куче, если он есть, остаётся для повторного заполнения
+    void Clear() noexcept;
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args);
+    iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/;
+    iterator Insert(const_iterator pos, const T& value);
+    iterator Insert(const_iterator pos, T&& value);
+
+private:
+    // Буфер в куче; пуст, пока элементы помещаются во встроенный буфер
+    RawMemory<T, Allocator> heap_;
+    alignas(T) unsigned char inline_buffer_[N * sizeof(T)];
+    size_t size_ = 0;
+
+    T* Inline_Data() noexcept {
+        return reinterpret_cast<T*>(inline_buffer_);
+    }
+
+    T* Data() noexcept {
+        return IsInline() ? Inline_Data() : heap_.GetAddress();
+    }
+
+    const T* Data() const noexcept {
+        return const_cast<SmallVector&>(*this).Data();
+    }
+
+    size_t Next_Capacity(size_t required) const noexcept {
+        return GrowthPolicy::NextCapacity(Capacity(), required, sizeof(T));
+    }
+
+    // Переносит элементы встроенного буфера other во встроенный буфер *this, который должен быть пуст
+    void Take_Inline(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+};
+
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const Allocator& alloc) noexcept
+    : heap_(alloc) //
+{
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(size_t size, const Allocator& alloc)
+    : heap_(size > N ? size : 0, alloc) //
+{
+    std::uninitialized_value_construct_n(Data(), size);
+    size_ = size;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector& other)
+    : heap_(other.size_ > N ? other.size_ : 0,
+            std::allocator_traits<Allocator>::select_on_container_copy_construction(other.heap_.GetAllocator())) //
+{
+    std::uninitialized_copy_n(other.Data(), other.size_, Data());
+    size_ = other.size_;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : heap_(other.heap_.GetAllocator()) //
+{
+    if (other.IsInline()) {
+        Take_Inline(other);
+    } else {
+        heap_.Swap(other.heap_);
+        size_ = std::exchange(other.size_, 0);
+    }
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::~SmallVector() {
+    std::destroy_n(Data(), size_);
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>& SmallVector<T, N, Allocator, GrowthPolicy>::operator=(const SmallVector& rhs) {
+    if (this != &rhs) {
+        if (rhs.size_ > Capacity()) {
+            /* Применить copy-and-swap */
+            SmallVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        } else {
+            /* Скопировать элементы из rhs, создав при необходимости новые
+               или удалив существующие */
+            const size_t common = std::min(size_, rhs.size_);
+            std::copy_n(rhs.Data(), common, Data());
+            if (rhs.size_ > size_) {
+                std::uninitialized_copy_n(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+            } else {
+                std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+            }
+            size_ = rhs.size_;
+        }
+    }
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>& SmallVector<T, N, Allocator, GrowthPolicy>::operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    Swap(rhs);
+    return *this;
+}
+
+//Итераторы
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::begin() noexcept {
+    return Data();
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::end() noexcept {
+    return Data() + size_;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::begin() const noexcept {
+    return Data();
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::end() const noexcept {
+    return Data() + size_;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::cbegin() const noexcept {
+    return begin();
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::cend() const noexcept {
+    return end();
+}
+
+//методы
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Take_Inline(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    assert(IsInline() && size_ == 0 && other.IsInline());
+    detail::Relocate_N(other.Inline_Data(), other.size_, Inline_Data());
+    size_ = std::exchange(other.size_, 0);
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Reserve(size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    RawMemory<T, Allocator> new_data(new_capacity, heap_.GetAllocator());
+    detail::Relocate_N(Data(), size_, new_data.GetAddress());
+    heap_.Swap(new_data);
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this == &other) {
+        return;
+    }
+    if (!IsInline() && !other.IsInline()) {
+        heap_.Swap(other.heap_);
+        std::swap(size_, other.size_);
+    } else if (IsInline() && other.IsInline()) {
+        // Общая часть обменивается поэлементно, остаток переносится в меньший вектор
+        SmallVector& larger = size_ >= other.size_ ? *this : other;
+        SmallVector& smaller = size_ >= other.size_ ? other : *this;
+        const size_t common = smaller.size_;
+        std::swap_ranges(larger.Inline_Data(), larger.Inline_Data() + common, smaller.Inline_Data());
+        detail::Relocate_N(larger.Inline_Data() + common, larger.size_ - common, smaller.Inline_Data() + common);
+        std::swap(size_, other.size_);
+    } else {
+        // Элементы встроенного буфера переходят во встроенный буфер вектора, хранящего данные в куче,
+        // после чего буфер в куче передаётся другому вектору
+        SmallVector& on_heap = IsInline() ? other : *this;
+        SmallVector& in_place = IsInline() ? *this : other;
+        detail::Relocate_N(in_place.Inline_Data(), in_place.size_, on_heap.Inline_Data());
+        on_heap.heap_.Swap(in_place.heap_);
+        std::swap(size_, other.size_);
+    }
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Resize(size_t new_size) {
+    Reserve(new_size);
+    if (size_ > new_size) {
+        std::destroy_n(Data() + new_size, size_ - new_size);
+    } else if (size_ < new_size) {
+        std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+    }
+    size_ = new_size;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PushBack(const T& value) {
+    EmplaceBack(value);
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PushBack(T&& value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PopBack() {
+    if (size_ > 0) {
+        std::destroy_at(Data() + size_ - 1);
+        --size_;
+    }
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Clear() noexcept {
+    std::destroy_n(Data(), size_);
+    size_ = 0;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::EmplaceBack(Args&&... args) {
+    T* elem = nullptr;
+    if (size_ == Capacity()) {
+        // Новый элемент создаётся до переноса старых: аргументы могут ссылаться на элементы вектора
+        RawMemory<T, Allocator> new_data(Next_Capacity(size_ + 1), heap_.GetAllocator());
+        elem = new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
+        try {
+            detail::Relocate_N(Data(), size_, new_data.GetAddress());
+        } catch (...) {
+            std::destroy_at(elem);
+            throw;
+        }
+        heap_.Swap(new_data);
+    } else {
+        elem = new (Data() + size_) T(std::forward<Args>(args)...);
+    }
+    ++size_;
+    return *elem;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::Emplace(const_iterator pos, Args&&... args) {
+
+    assert(pos >= begin() && pos <= end());
+
+    const size_t pos_num = pos - begin();
+    iterator elem_pos = nullptr;
+
+    if (size_ == Capacity()) {
+        RawMemory<T, Allocator> new_data(Next_Capacity(size_ + 1), heap_.GetAllocator());
+        elem_pos = new (new_data.GetAddress() + pos_num) T(std::forward<Args>(args)...);
+        if constexpr (is_trivially_relocatable_v<T>) {
+            detail::Relocate_N(begin(), pos_num, new_data.GetAddress());
+            detail::Relocate_N(begin() + pos_num, size_ - pos_num, new_data.GetAddress() + (pos_num + 1));
+        } else {
+            // Старые элементы разрушаются только после успешного копирования обеих частей
+            try {
+                detail::Uninitialized_Move_Or_Copy_N(begin(), pos_num, new_data.GetAddress());
+                try {
+                    detail::Uninitialized_Move_Or_Copy_N(begin() + pos_num, size_ - pos_num, new_data.GetAddress() + (pos_num + 1));
+                } catch (...) {
+                    std::destroy_n(new_data.GetAddress(), pos_num);
+                    throw;
+                }
+            } catch (...) {
+                std::destroy_at(elem_pos);
+                throw;
+            }
+            std::destroy_n(begin(), size_);
+        }
+        heap_.Swap(new_data);
+    } else if constexpr (is_trivially_relocatable_v<T>) {
+        // Новый элемент создаётся до сдвига: аргументы могут ссылаться на элементы вектора
+        alignas(T) unsigned char temp[sizeof(T)];
+        new (temp) T(std::forward<Args>(args)...);
+        elem_pos = begin() + pos_num;
+        std::memmove(static_cast<void*>(elem_pos + 1), static_cast<const void*>(elem_pos), (size_ - pos_num) * sizeof(T));
+        std::memcpy(static_cast<void*>(elem_pos), temp, sizeof(T));
+    } else if (pos_num != size_) {
+        T temp = T(std::forward<Args>(args)...);
+        new (end()) T(std::move(*(end() - 1)));
+        std::move_backward(begin() + pos_num, end() - 1, end());
+        elem_pos = begin() + pos_num;
+        *elem_pos = std::move(temp);
+    } else {
+        elem_pos = new (end()) T(std::forward<Args>(args)...);
+    }
+    ++size_;
+    return elem_pos;
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::Insert(const_iterator pos, const T& value) {
+    return Emplace(pos, value);
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::Insert(const_iterator pos, T&& value) {
+    return Emplace(pos, std::move(value));
+}
+
+template <typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::Erase(const_iterator pos) {
+
+    assert(pos >= begin() && pos < end());
+
+    auto elem_pos = begin() + (pos - begin());
+    if constexpr (is_trivially_relocatable_v<T>) {
+        std::destroy_at(elem_pos);
+        std::memmove(static_cast<void*>(elem_pos), static_cast<const void*>(elem_pos + 1), (end() - elem_pos - 1) * sizeof(T));
+    } else {
+        std::move(elem_pos + 1, end(), elem_pos);
+        std::destroy_at(end() - 1);
+    }
+    --size_;
+    return elem_pos;
+}
@@ -0,0 +1,335 @@
+#pragma once
+#include "vector.h"
+
+#include <tuple>
+
+// Вектор строк из полей Ts..., который хранит каждое поле отдельным непрерывным столбцом RawMemory
+// («структура массивов»). Цикл, читающий одно-два поля, проходит только по их столбцам, и кэш-линии
+// не заполняются остальными полями; столбец доступен как Span для векторизованных алгоритмов (simd.h).
+// Размер и вместимость у столбцов общие, при росте все столбцы переносятся вместе.
+// operator[] возвращает ссылку-заместитель std::tuple<Ts&...> на поля строки.
+// Поля должны перемещаться без исключений: тогда перенос и сдвиг столбцов не нужно откатывать
+template <typename... Ts>
+class SoAVector {
+    static_assert(sizeof...(Ts) > 0, "SoAVector needs at least one field");
+    static_assert((std::is_nothrow_move_constructible_v<Ts> && ...), "fields are relocated column by column");
+    static_assert((std::is_nothrow_move_assignable_v<Ts> && ...), "fields are shifted column by column");
+
+    using Columns = std::tuple<RawMemory<Ts>...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+public:
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Ts...>>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+
+    static constexpr size_t NUM_COLUMNS = sizeof...(Ts);
+    // Байт на строку во всех столбцах
+    static constexpr size_t ROW_SIZE = (sizeof(Ts) + ...);
+
+    SoAVector() = default;
+    explicit SoAVector(size_t size);
+    SoAVector(const SoAVector& other);
+    SoAVector(SoAVector&& other) noexcept;
+
+    ~SoAVector();
+
+    SoAVector& operator=(const SoAVector& rhs);
+    SoAVector& operator=(SoAVector&& rhs) noexcept;
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        return const_cast<SoAVector&>(*this)[index];
+    }
+
+    // Столбец поля I
+    template <size_t I>
+    Span<FieldType<I>> Column() noexcept {
+        return Span<FieldType<I>>(std::get<I>(columns_).GetAddress(), size_);
+    }
+
+    template <size_t I>
+    ConstSpan<FieldType<I>> Column() const noexcept {
+        return const_cast<SoAVector&>(*this).template Column<I>();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    void Reserve(size_t new_capacity);
+    void Swap(SoAVector& other) noexcept;
+    void Clear() noexcept;
+    void Resize(size_t new_size);
+    void PopBack() noexcept;
+
+    // Создаёт строку из значений полей: i-й аргумент передаётся конструктору i-го поля
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args);
+
+    // Вставляет строку перед строкой index и возвращает ссылку на неё
+    template <typename... Args>
+    reference Insert(size_t index, Args&&... args);
+
+    void Erase(size_t index) noexcept;
+    // Удаляет строки [first, last)
+    void Erase(size_t first, size_t last) noexcept;
+
+private:
+    Columns columns_;
+    size_t size_ = 0;
+
+    template <size_t... I>
+    reference Row(size_t index, std::index_sequence<I...>) noexcept {
+        return reference(std::get<I>(columns_)[index]...);
+    }
+
+    size_t Next_Capacity(size_t required) const noexcept {
+        return DoublingGrowth::NextCapacity(Capacity(), required, ROW_SIZE);
+    }
+
+    // Вызывает f(column) для каждого столбца
+    template <typename F>
+    static void For_Each_Column(Columns& columns, F&& f) {
+        std::apply([&f](auto&... column) {
+            (f(column), ...);
+        }, columns);
+    }
+
+    // Вызывает construct(column, std::integral_constant<size_t, I>) по очереди для столбцов. Если какой-то
+    // вызов выбросил исключение, для уже обработанных столбцов вызывается destroy(column)
+    template <typename Construct, typename Destroy>
+    static void Construct_Columns(Columns& columns, Construct&& construct, Destroy&& destroy) {
+        Construct_Columns(columns, construct, destroy, Indices{});
+    }
+
+    template <typename Construct, typename Destroy, size_t... I>
+    static void Construct_Columns(Columns& columns, Construct& construct, Destroy& destroy, std::index_sequence<I...>) {
+        size_t done = 0;
+        try {
+            ((construct(std::get<I>(columns), std::integral_constant<size_t, I>{}), ++done), ...);
+        } catch (...) {
+            ((I < done ? destroy(std::get<I>(columns)) : void()), ...);
+            throw;
+        }
+    }
+
+    // Создаёт строку row в columns из аргументов полей
+    template <typename... Args>
+    static void Construct_Row(Columns& columns, size_t row, Args&&... args);
+
+    // Переносит строки в новые столбцы; перемещение полей не выбрасывает исключений
+    template <size_t... I>
+    void Relocate_To(Columns& new_columns, std::index_sequence<I...>) noexcept {
+        (detail::Relocate_N(std::get<I>(columns_).GetAddress(), size_, std::get<I>(new_columns).GetAddress()), ...);
+    }
+
+    // Сдвигает строки [index, size_) на одну вправо и перемещает на место index поля row
+    template <size_t... I>
+    void Shift_Insert(size_t index, std::tuple<Ts...>& row, std::index_sequence<I...>) noexcept {
+        (Shift_Column(std::get<I>(columns_).GetAddress(), index, size_, std::get<I>(row)), ...);
+    }
+
+    template <typename T>
+    static void Shift_Column(T* data, size_t index, size_t size, T& value) noexcept {
+        new (data + size) T(std::move(data[size - 1]));
+        std::move_backward(data + index, data + size - 1, data + size);
+        data[index] = std::move(value);
+    }
+};
+
+
+template <typename... Ts>
+SoAVector<Ts...>::SoAVector(size_t size)
+    : columns_(RawMemory<Ts>(size)...) //
+{
+    Construct_Columns(
+        columns_,
+        [size](auto& column, auto) {
+            std::uninitialized_value_construct_n(column.GetAddress(), size);
+        },
+        [size](auto& column) {
+            std::destroy_n(column.GetAddress(), size);
+        });
+    size_ = size;
+}
+
+template <typename... Ts>
+SoAVector<Ts...>::SoAVector(const SoAVector& other)
+    : columns_(RawMemory<Ts>(other.size_)...) //
+{
+    const size_t size = other.size_;
+    Construct_Columns(
+        columns_,
+        [&other, size](auto& column, auto index) {
+            std::uninitialized_copy_n(std::get<decltype(index)::value>(other.columns_).GetAddress(), size, column.GetAddress());
+        },
+        [size](auto& column) {
+            std::destroy_n(column.GetAddress(), size);
+        });
+    size_ = size;
+}
+
+template <typename... Ts>
+SoAVector<Ts...>::SoAVector(SoAVector&& other) noexcept
+    : columns_(std::move(other.columns_))
+    , size_(std::exchange(other.size_, 0)) //
+{
+}
+
+template <typename... Ts>
+SoAVector<Ts...>::~SoAVector() {
+    Clear();
+}
+
+template <typename... Ts>
+SoAVector<Ts...>& SoAVector<Ts...>::operator=(const SoAVector& rhs) {
+    if (this != &rhs) {
+        /* Применить copy-and-swap */
+        SoAVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename... Ts>
+SoAVector<Ts...>& SoAVector<Ts...>::operator=(SoAVector&& rhs) noexcept {
+    Swap(rhs);
+    return *this;
+}
+
+template <typename... Ts>
+void SoAVector<Ts...>::Reserve(size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    // Все столбцы выделяются до переноса, поэтому нехватка памяти не оставляет вектор частично перенесённым
+    Columns new_columns{RawMemory<Ts>(new_capacity)...};
+    Relocate_To(new_columns, Indices{});
+    columns_.swap(new_columns);
+}
+
+template <typename... Ts>
+void SoAVector<Ts...>::Swap(SoAVector& other) noexcept {
+    columns_.swap(other.columns_);
+    std::swap(size_, other.size_);
+}
+
+template <typename... Ts>
+void SoAVector<Ts...>::Clear() noexcept {
+    const size_t size = size_;
+    For_Each_Column(columns_, [size](auto& column) {
+        std::destroy_n(column.GetAddress(), size);
+    });
+    size_ = 0;
+}
+
+template <typename... Ts>
+void SoAVector<Ts...>::Resize(size_t new_size) {
+    const size_t size = size_;
+    if (new_size < size) {
+        For_Each_Column(columns_, [new_size, size](auto& column) {
+            std::destroy_n(column.GetAddress() + new_size, size - new_size);
+        });
+        size_ = new_size;
+        return;
+    }
+    Reserve(new_size);
+    Construct_Columns(
+        columns_,
+        [new_size, size](auto& column, auto) {
+            std::uninitialized_value_construct_n(column.GetAddress() + size, new_size - size);
+        },
+        [new_size, size](auto& column) {
+            std::destroy_n(column.GetAddress() + size, new_size - size);
+        });
+    size_ = new_size;
+}
+
+template <typename... Ts>
+void SoAVector<Ts...>::PopBack() noexcept {
+    assert(size_ > 0);
+    --size_;
+    const size_t last = size_;
+    For_Each_Column(columns_, [last](auto& column) {
+        std::destroy_at(column.GetAddress() + last);
+    });
+}
+
+template <typename... Ts>
+template <typename... Args>
+void SoAVector<Ts...>::Construct_Row(Columns& columns, size_t row, Args&&... args) {
+    static_assert(sizeof...(Args) == sizeof...(Ts), "EmplaceBack takes one argument per field");
+    auto fields = std::forward_as_tuple(std::forward<Args>(args)...);
+    Construct_Columns(
+        columns,
+        [row, &fields](auto& column, auto index) {
+            using Field = FieldType<decltype(index)::value>;
+            new (column.GetAddress() + row) Field(std::get<decltype(index)::value>(std::move(fields)));
+        },
+        [row](auto& column) {
+            std::destroy_at(column.GetAddress() + row);
+        });
+}
+
+template <typename... Ts>
+template <typename... Args>
+typename SoAVector<Ts...>::reference SoAVector<Ts...>::EmplaceBack(Args&&... args) {
+    if (size_ == Capacity()) {
+        // Строка создаётся в новых столбцах до переноса старых, поэтому args могут ссылаться на поля вектора
+        Columns new_columns{RawMemory<Ts>(Next_Capacity(size_ + 1))...};
+        Construct_Row(new_columns, size_, std::forward<Args>(args)...);
+        Relocate_To(new_columns, Indices{});
+        columns_.swap(new_columns);
+    } else {
+        Construct_Row(columns_, size_, std::forward<Args>(args)...);
+    }
+    ++size_;
+    return (*this)[size_ - 1];
+}
+
+template <typename... Ts>
+template <typename... Args>
+typename SoAVector<Ts...>::reference SoAVector<Ts...>::Insert(size_t index, Args&&... args) {
+    assert(index <= size_);
+    if (index == size_) {
+        return EmplaceBack(std::forward<Args>(args)...);
+    }
+    // Строка собирается заранее: args могут ссылаться на поля, которые сдвинет вставка
+    std::tuple<Ts...> row(std::forward<Args>(args)...);
+    if (size_ == Capacity()) {
+        Reserve(Next_Capacity(size_ + 1));
+    }
+    Shift_Insert(index, row, Indices{});
+    ++size_;
+    return (*this)[index];
+}
+
+template <typename... Ts>
+void SoAVector<Ts...>::Erase(size_t index) noexcept {
+    Erase(index, index + 1);
+}
+
+template <typename... Ts>
+void SoAVector<Ts...>::Erase(size_t first, size_t last) noexcept {
+    assert(first <= last && last <= size_);
+    if (first == last) {
+        return;
+    }
+    const size_t size = size_;
+    For_Each_Column(columns_, [first, last, size](auto& column) {
+        auto* data = column.GetAddress();
+        std::move(data + last, data + size, data + first);
+        std::destroy_n(data + size - (last - first), last - first);
+    });
+    size_ -= last - first;
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+// Начало и размер непрерывного контейнера: data() и size() стандартных контейнеров либо begin(),
+// возвращающий указатель, и Size() контейнеров библиотеки (Vector, SmallVector, MappedVector)
+template <typename Container>
+auto Span_Data(Container& container, int) -> decltype(container.data()) {
+    return container.data();
+}
+
+template <typename Container>
+auto Span_Data(Container& container, long)
+    -> std::enable_if_t<std::is_pointer_v<decltype(container.begin())>, decltype(container.begin())> {
+    return container.begin();
+}
+
+template <typename Container>
+auto Span_Size(Container& container, int) -> decltype(container.size()) {
+    return container.size();
+}
+
+template <typename Container>
+auto Span_Size(Container& container, long) -> decltype(container.Size()) {
+    return container.Size();
+}
+
+template <typename Container>
+using span_pointer_t = decltype(Span_Data(std::declval<Container&>(), 0));
+
+}  // namespace detail
+
+// Невладеющее представление непрерывного диапазона Size() элементов типа T, начинающегося с Data().
+// Span<const T> даёт доступ только для чтения
+template <typename T>
+class Span {
+public:
+    using iterator = T*;
+
+    Span() = default;
+
+    Span(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    // Span<T> неявно приводится к Span<const T>
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+    Span(const Span<U>& other) noexcept
+        : data_(other.Data())
+        , size_(other.Size()) {
+    }
+
+    // Представление всех элементов непрерывного контейнера. Временный контейнер не принимается,
+    // чтобы представление не пережило его
+    template <typename Container, typename Pointer = detail::span_pointer_t<Container>,
+              typename = std::enable_if_t<std::is_convertible_v<std::remove_pointer_t<Pointer> (*)[], T (*)[]>>>
+    Span(Container& container) noexcept
+        : data_(detail::Span_Data(container, 0))
+        , size_(static_cast<size_t>(detail::Span_Size(container, 0))) {
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    iterator begin() const noexcept {
+        return data_;
+    }
+
+    iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    // Элементы [offset, Size())
+    Span Subspan(size_t offset) const noexcept {
+        assert(offset <= size_);
+        return Span(data_ + offset, size_ - offset);
+    }
+
+    // Элементы [offset, offset + count)
+    Span Subspan(size_t offset, size_t count) const noexcept {
+        assert(offset <= size_ && count <= size_ - offset);
+        return Span(data_ + offset, count);
+    }
+
+    // Первые count элементов
+    Span First(size_t count) const noexcept {
+        return Subspan(0, count);
+    }
+
+    // Последние count элементов
+    Span Last(size_t count) const noexcept {
+        assert(count <= size_);
+        return Span(data_ + size_ - count, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename Container>
+Span(Container&) -> Span<std::remove_pointer_t<detail::span_pointer_t<Container>>>;
+
+template <typename T>
+using ConstSpan = Span<const T>;
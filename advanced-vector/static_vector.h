@@ -0,0 +1,439 @@
+#pragma once
+#include "vector.h"
+
+#include <initializer_list>
+
+// Политики переполнения StaticVector: что делать, если операции нужно больше N элементов.
+// Политика — тип со статическим методом Overflow(required, capacity), который не возвращает управление.
+// Методы Try* не вызывают политику и сообщают о нехватке места результатом
+
+// Нарушение предусловия: assert в отладочной сборке, std::abort в остальных
+struct AbortOnOverflow {
+    [[noreturn]] static void Overflow(size_t /*required*/, size_t /*capacity*/) noexcept {
+        assert(!"StaticVector capacity exceeded");
+        std::abort();
+    }
+};
+
+// Исключение std::length_error; вектор при этом не изменяется
+struct ThrowOnOverflow {
+    [[noreturn]] static void Overflow(size_t /*required*/, size_t /*capacity*/) {
+        throw std::length_error("StaticVector capacity exceeded");
+    }
+};
+
+namespace detail {
+
+// Встроенный буфер на N элементов и размер. Для тривиально копируемых T копирование, перемещение
+// и разрушение остаются тривиальными, и StaticVector копируется как обычная структура (memcpy)
+template <typename T, size_t N, bool = std::is_trivially_copyable_v<T>>
+class StaticStorage {
+public:
+    StaticStorage() = default;
+
+protected:
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+    size_t size_ = 0;
+
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(buffer_);
+    }
+
+    const T* Data() const noexcept {
+        return reinterpret_cast<const T*>(buffer_);
+    }
+};
+
+// Копирование и перемещение обходят только size_ элементов; после перемещения источник пуст
+template <typename T, size_t N>
+class StaticStorage<T, N, false> {
+public:
+    StaticStorage() = default;
+    StaticStorage(const StaticStorage& other);
+    StaticStorage(StaticStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    ~StaticStorage();
+
+    StaticStorage& operator=(const StaticStorage& rhs);
+    StaticStorage& operator=(StaticStorage&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                            && std::is_nothrow_move_assignable_v<T>);
+
+protected:
+    alignas(T) unsigned char buffer_[N * sizeof(T)];
+    size_t size_ = 0;
+
+    T* Data() noexcept {
+        return reinterpret_cast<T*>(buffer_);
+    }
+
+    const T* Data() const noexcept {
+        return reinterpret_cast<const T*>(buffer_);
+    }
+};
+
+template <typename T, size_t N>
+StaticStorage<T, N, false>::StaticStorage(const StaticStorage& other) {
+    Uninitialized_Copy_N(other.Data(), other.size_, Data());
+    size_ = other.size_;
+}
+
+template <typename T, size_t N>
+StaticStorage<T, N, false>::StaticStorage(StaticStorage&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    Relocate_N(other.Data(), other.size_, Data());
+    size_ = std::exchange(other.size_, 0);
+}
+
+template <typename T, size_t N>
+StaticStorage<T, N, false>::~StaticStorage() {
+    Destroy_N(Data(), size_);
+}
+
+template <typename T, size_t N>
+StaticStorage<T, N, false>& StaticStorage<T, N, false>::operator=(const StaticStorage& rhs) {
+    if (this != &rhs) {
+        /* Скопировать элементы из rhs, создав при необходимости новые
+           или удалив существующие */
+        const size_t common = std::min(size_, rhs.size_);
+        std::copy_n(rhs.Data(), common, Data());
+        if (rhs.size_ > size_) {
+            Uninitialized_Copy_N(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+        } else {
+            Destroy_N(Data() + rhs.size_, size_ - rhs.size_);
+        }
+        size_ = rhs.size_;
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+StaticStorage<T, N, false>& StaticStorage<T, N, false>::operator=(StaticStorage&& rhs) noexcept(
+    std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+    if (this != &rhs) {
+        const size_t common = std::min(size_, rhs.size_);
+        std::move(rhs.Data(), rhs.Data() + common, Data());
+        if (rhs.size_ > size_) {
+            Uninitialized_Move_Or_Copy_N(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+        } else {
+            Destroy_N(Data() + rhs.size_, size_ - rhs.size_);
+        }
+        size_ = rhs.size_;
+        Destroy_N(rhs.Data(), rhs.size_);
+        rhs.size_ = 0;
+    }
+    return *this;
+}
+
+}  // namespace detail
+
+// Вектор с фиксированной вместимостью N во встроенном выровненном буфере: память в куче не выделяется
+// никогда, включая копирование и перемещение. Интерфейс повторяет Vector; операция, которой нужно
+// больше N элементов, вызывает OverflowPolicy, а TryPushBack, TryEmplaceBack и TryEmplace вместо этого
+// возвращают false или nullptr, не изменяя вектор.
+// Если T тривиально копируем, StaticVector тоже тривиально копируем
+template <typename T, size_t N, typename OverflowPolicy = AbortOnOverflow>
+class StaticVector : private detail::StaticStorage<T, N> {
+    static_assert(N > 0, "capacity must be positive");
+
+    using Storage = detail::StaticStorage<T, N>;
+    using Storage::size_;
+    using Storage::Data;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t CAPACITY = N;
+
+    StaticVector() = default;
+    explicit StaticVector(size_t size);
+    StaticVector(std::initializer_list<T> values);
+
+    iterator begin() noexcept;
+    iterator end() noexcept;
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<StaticVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    bool IsFull() const noexcept {
+        return size_ == N;
+    }
+
+    // Память не выделяется; вызывает OverflowPolicy, если new_capacity больше N
+    void Reserve(size_t new_capacity);
+    void Swap(StaticVector& other) noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>);
+    void Clear() noexcept;
+    void Resize(size_t new_size);
+    void PushBack(const T& value);
+    void PushBack(T&& value);
+    void PopBack() noexcept;
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args);
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args);
+    iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/;
+    // Удаляет элементы [first, last): хвост сдвигается один раз
+    iterator Erase(const_iterator first, const_iterator last);
+    iterator Insert(const_iterator pos, const T& value);
+    iterator Insert(const_iterator pos, T&& value);
+
+    // Добавляют элемент, если есть место; иначе возвращают false, и вектор не изменяется
+    bool TryPushBack(const T& value);
+    bool TryPushBack(T&& value);
+    template <typename... Args>
+    bool TryEmplaceBack(Args&&... args);
+    // Вставленный элемент или nullptr, если места нет
+    template <typename... Args>
+    iterator TryEmplace(const_iterator pos, Args&&... args);
+
+private:
+    // Вызывает политику переполнения, если required больше N
+    static void Check_Capacity(size_t required) {
+        if (required > N) {
+            OverflowPolicy::Overflow(required, N);
+        }
+    }
+
+    // Вставка при известном свободном месте. Позиция передаётся итератором, а не индексом: GCC 12 при -O2
+    // превращает индексный параметр (IPA-SRA) и ошибочно считает, что возвращённый итератор не равен pos
+    template <typename... Args>
+    iterator Emplace_Unchecked(const_iterator pos, Args&&... args);
+    // Удаляет count элементов с позиции first, сдвигая на их место хвост; size_ не изменяется
+    void Close_Gap(iterator first, size_t count);
+};
+
+
+template <typename T, size_t N, typename OverflowPolicy>
+StaticVector<T, N, OverflowPolicy>::StaticVector(size_t size) {
+    Check_Capacity(size);
+    detail::Uninitialized_Value_Construct_N(Data(), size);
+    size_ = size;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+StaticVector<T, N, OverflowPolicy>::StaticVector(std::initializer_list<T> values) {
+    Check_Capacity(values.size());
+    detail::Uninitialized_Copy_N(values.begin(), values.size(), Data());
+    size_ = values.size();
+}
+
+//Итераторы
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::begin() noexcept {
+    return Data();
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::end() noexcept {
+    return Data() + size_;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::const_iterator StaticVector<T, N, OverflowPolicy>::begin() const noexcept {
+    return Data();
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::const_iterator StaticVector<T, N, OverflowPolicy>::end() const noexcept {
+    return Data() + size_;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::const_iterator StaticVector<T, N, OverflowPolicy>::cbegin() const noexcept {
+    return begin();
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::const_iterator StaticVector<T, N, OverflowPolicy>::cend() const noexcept {
+    return end();
+}
+
+//методы
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::Reserve(size_t new_capacity) {
+    Check_Capacity(new_capacity);
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::Swap(StaticVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                                           && std::is_nothrow_swappable_v<T>) {
+    if (this == &other) {
+        return;
+    }
+    // Общая часть обменивается поэлементно, остаток переносится в меньший вектор
+    StaticVector& larger = size_ >= other.size_ ? *this : other;
+    StaticVector& smaller = size_ >= other.size_ ? other : *this;
+    const size_t common = smaller.size_;
+    std::swap_ranges(larger.Data(), larger.Data() + common, smaller.Data());
+    detail::Relocate_N(larger.Data() + common, larger.size_ - common, smaller.Data() + common);
+    std::swap(size_, other.size_);
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::Clear() noexcept {
+    detail::Destroy_N(Data(), size_);
+    size_ = 0;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::Resize(size_t new_size) {
+    Check_Capacity(new_size);
+    if (size_ > new_size) {
+        detail::Destroy_N(Data() + new_size, size_ - new_size);
+    } else if (size_ < new_size) {
+        detail::Uninitialized_Value_Construct_N(Data() + size_, new_size - size_);
+    }
+    size_ = new_size;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::PushBack(const T& value) {
+    EmplaceBack(value);
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::PushBack(T&& value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::PopBack() noexcept {
+    // Как и у Vector, у пустого вектора ничего не происходит
+    if (size_ > 0) {
+        --size_;
+        std::destroy_at(Data() + size_);
+    }
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Args>
+T& StaticVector<T, N, OverflowPolicy>::EmplaceBack(Args&&... args) {
+    Check_Capacity(size_ + 1);
+    T* elem = detail::Construct_At(Data() + size_, std::forward<Args>(args)...);
+    ++size_;
+    return *elem;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Args>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Emplace(const_iterator pos, Args&&... args) {
+    assert(pos >= begin() && pos <= end());
+    Check_Capacity(size_ + 1);
+    return Emplace_Unchecked(pos, std::forward<Args>(args)...);
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Args>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Emplace_Unchecked(const_iterator pos, Args&&... args) {
+    const size_t pos_num = pos - begin();
+    iterator elem_pos = begin() + pos_num;
+    if constexpr (is_trivially_relocatable_v<T>) {
+        // Новый элемент создаётся до сдвига: аргументы могут ссылаться на элементы вектора
+        alignas(T) unsigned char temp[sizeof(T)];
+        new (temp) T(std::forward<Args>(args)...);
+        std::memmove(static_cast<void*>(elem_pos + 1), static_cast<const void*>(elem_pos), (size_ - pos_num) * sizeof(T));
+        std::memcpy(static_cast<void*>(elem_pos), temp, sizeof(T));
+    } else if (pos_num != size_) {
+        T temp = T(std::forward<Args>(args)...);
+        new (end()) T(std::move(*(end() - 1)));
+        std::move_backward(elem_pos, end() - 1, end());
+        *elem_pos = std::move(temp);
+    } else {
+        new (end()) T(std::forward<Args>(args)...);
+    }
+    ++size_;
+    return elem_pos;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Insert(const_iterator pos, const T& value) {
+    return Emplace(pos, value);
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Insert(const_iterator pos, T&& value) {
+    return Emplace(pos, std::move(value));
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Erase(const_iterator pos) {
+    assert(pos >= begin() && pos < end());
+    iterator elem_pos = begin() + (pos - begin());
+    Close_Gap(elem_pos, 1);
+    --size_;
+    return elem_pos;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::Erase(const_iterator first, const_iterator last) {
+    assert(begin() <= first && first <= last && last <= end());
+    iterator first_pos = begin() + (first - begin());
+    const size_t count = last - first;
+    if (count != 0) {
+        Close_Gap(first_pos, count);
+        size_ -= count;
+    }
+    return first_pos;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+void StaticVector<T, N, OverflowPolicy>::Close_Gap(iterator first, size_t count) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        detail::Destroy_N(first, count);
+        std::memmove(static_cast<void*>(first), static_cast<const void*>(first + count), (end() - first - count) * sizeof(T));
+    } else {
+        std::move(first + count, end(), first);
+        detail::Destroy_N(end() - count, count);
+    }
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+bool StaticVector<T, N, OverflowPolicy>::TryPushBack(const T& value) {
+    return TryEmplaceBack(value);
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+bool StaticVector<T, N, OverflowPolicy>::TryPushBack(T&& value) {
+    return TryEmplaceBack(std::move(value));
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Args>
+bool StaticVector<T, N, OverflowPolicy>::TryEmplaceBack(Args&&... args) {
+    if (size_ == N) {
+        return false;
+    }
+    detail::Construct_At(Data() + size_, std::forward<Args>(args)...);
+    ++size_;
+    return true;
+}
+
+template <typename T, size_t N, typename OverflowPolicy>
+template <typename... Args>
+typename StaticVector<T, N, OverflowPolicy>::iterator StaticVector<T, N, OverflowPolicy>::TryEmplace(const_iterator pos, Args&&... args) {
+    assert(pos >= begin() && pos <= end());
+    if (size_ == N) {
+        return nullptr;
+    }
+    return Emplace_Unchecked(pos, std::forward<Args>(args)...);
+}
@@ -1,120 +1,1034 @@
 #pragma once
 #include <cassert>
 #include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <exception>
 #include <new>
 #include <utility>
 #include <memory>
+#include <memory_resource>
 #include <algorithm>
+#include <functional>
+#include <iterator>
 
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 
+#if defined(ADVANCED_VECTOR_STATS)
+#include <atomic>
+#endif
 
+#include "span.h"
+
+// Признак типа, объект которого можно перенести в другую память побайтовым копированием,
+// не вызывая для исходного объекта деструктор. По умолчанию верен для тривиально копируемых типов.
+// Шаблон можно специализировать для своих типов, например для дескрипторов вида unique_ptr.
+// Внимание: std::string в libstdc++ хранит указатель на собственный буфер и этим свойством не обладает
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace detail {
+
+// Тип с неявным временем жизни: его объекты возникают в выделенной памяти без вызова конструктора,
+// поэтому неинициализированные элементы такого типа можно заполнить записью байтов (read, recv, memcpy)
+#if defined(__cpp_lib_is_implicit_lifetime)
+template <typename T>
+inline constexpr bool is_implicit_lifetime_v = std::is_implicit_lifetime_v<T>;
+#else
+template <typename T>
+inline constexpr bool is_implicit_lifetime_v = std::is_scalar_v<T> || std::is_array_v<T>
+    || (std::is_trivially_destructible_v<T>
+        && (std::is_aggregate_v<T> || std::is_trivially_default_constructible_v<T>
+            || std::is_trivially_copy_constructible_v<T> || std::is_trivially_move_constructible_v<T>));
+#endif
+
+}  // namespace detail
+
+// RawMemory и основные операции Vector (конструкторы, доступ, Reserve, Resize, PushBack, EmplaceBack,
+// Emplace, Insert и Erase одного элемента) доступны в константных выражениях, если стандартная библиотека
+// выделяет память во время компиляции (C++20). Так небольшие таблицы можно построить при компиляции
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+#define ADVANCED_VECTOR_CONSTEXPR constexpr
+#else
+#define ADVANCED_VECTOR_CONSTEXPR
+#endif
+
+namespace detail {
+
+// Вычисление идёт во время компиляции: memcpy, memmove и статистика там недоступны
+constexpr bool Is_Constant_Evaluated() noexcept {
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+template <typename T, typename... Args>
+ADVANCED_VECTOR_CONSTEXPR T* Construct_At(T* p, Args&&... args) {
+#if defined(__cpp_lib_constexpr_dynamic_alloc)
+    return std::construct_at(p, std::forward<Args>(args)...);
+#else
+    return new (p) T(std::forward<Args>(args)...);
+#endif
+}
+
+// Разрушает n элементов; для тривиально разрушаемых типов не порождает даже пустого цикла
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void Destroy_N(T* first, size_t n) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::destroy_n(first, n);
+    }
+}
+
+// Аналоги std::uninitialized_value_construct_n и std::uninitialized_copy_n, которые работают и во время
+// компиляции. Исключение там делает выражение неконстантным, поэтому откат созданных элементов не нужен
 template <typename T>
-class RawMemory {
+ADVANCED_VECTOR_CONSTEXPR void Uninitialized_Value_Construct_N(T* first, size_t n) {
+    if (Is_Constant_Evaluated()) {
+        for (size_t i = 0; i < n; ++i) {
+            Construct_At(first + i);
+        }
+        return;
+    }
+    std::uninitialized_value_construct_n(first, n);
+}
+
+template <typename InputIt, typename T>
+ADVANCED_VECTOR_CONSTEXPR void Uninitialized_Copy_N(InputIt src, size_t n, T* dst) {
+    if (Is_Constant_Evaluated()) {
+        for (size_t i = 0; i < n; ++i, ++src) {
+            Construct_At(dst + i, *src);
+        }
+        return;
+    }
+    std::uninitialized_copy_n(src, n, dst);
+}
+
+}  // namespace detail
+
+#if defined(ADVANCED_VECTOR_STATS)
+// Инструментирование выделений памяти и перевыделений. Включается макросом ADVANCED_VECTOR_STATS,
+// без него ни счётчики, ни поля статистики в RawMemory и Vector не компилируются
+
+// Выделения памяти всеми RawMemory
+struct VectorAllocationStats {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t reallocations = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t deallocated_bytes = 0;
+};
+
+// Статистика одного экземпляра Vector. Вектор, у которого reserve_calls == 0 при большом
+// числе reallocations, — кандидат на предварительный Reserve
+struct VectorInstanceStats {
+    size_t element_size = 0;
+    uint64_t reserve_calls = 0;
+    uint64_t reallocations = 0;
+    uint64_t relocated_elements = 0;
+    size_t peak_size = 0;
+    size_t peak_capacity = 0;
+};
+
+using VectorStatsCallback = void (*)(const VectorInstanceStats& stats);
+
+namespace detail {
+
+struct AtomicAllocationStats {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> deallocations{0};
+    std::atomic<uint64_t> reallocations{0};
+    std::atomic<uint64_t> allocated_bytes{0};
+    std::atomic<uint64_t> deallocated_bytes{0};
+};
+
+inline AtomicAllocationStats allocation_stats;
+inline std::atomic<VectorStatsCallback> stats_callback{nullptr};
+
+inline void Record_Allocation(size_t bytes) noexcept {
+    allocation_stats.allocations.fetch_add(1, std::memory_order_relaxed);
+    allocation_stats.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+inline void Record_Deallocation(size_t bytes) noexcept {
+    allocation_stats.deallocations.fetch_add(1, std::memory_order_relaxed);
+    allocation_stats.deallocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+inline void Record_Reallocation(size_t old_bytes, size_t new_bytes) noexcept {
+    allocation_stats.reallocations.fetch_add(1, std::memory_order_relaxed);
+    allocation_stats.deallocated_bytes.fetch_add(old_bytes, std::memory_order_relaxed);
+    allocation_stats.allocated_bytes.fetch_add(new_bytes, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+inline VectorAllocationStats GetVectorAllocationStats() noexcept {
+    const auto& stats = detail::allocation_stats;
+    return {stats.allocations.load(std::memory_order_relaxed), stats.deallocations.load(std::memory_order_relaxed),
+            stats.reallocations.load(std::memory_order_relaxed), stats.allocated_bytes.load(std::memory_order_relaxed),
+            stats.deallocated_bytes.load(std::memory_order_relaxed)};
+}
+
+inline void ResetVectorAllocationStats() noexcept {
+    auto& stats = detail::allocation_stats;
+    stats.allocations = 0;
+    stats.deallocations = 0;
+    stats.reallocations = 0;
+    stats.allocated_bytes = 0;
+    stats.deallocated_bytes = 0;
+}
+
+// callback вызывается при разрушении каждого Vector со статистикой этого экземпляра; nullptr отключает вызовы
+inline void SetVectorStatsCallback(VectorStatsCallback callback) noexcept {
+    detail::stats_callback.store(callback, std::memory_order_release);
+}
+#endif
+
+namespace detail {
+
+// Признак аллокатора с методом reallocate(p, old_n, new_n), изменяющим размер блока с сохранением содержимого
+template <typename Allocator, typename = void>
+struct has_reallocate : std::false_type {};
+
+template <typename Allocator>
+struct has_reallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+    std::declval<typename std::allocator_traits<Allocator>::pointer>(), size_t{}, size_t{}))>> : std::true_type {};
+
+// Признак политики роста с методом ShrinkCapacity(capacity, size, element_size) для автоматического сжатия
+template <typename GrowthPolicy, typename = void>
+struct has_shrink_capacity : std::false_type {};
+
+template <typename GrowthPolicy>
+struct has_shrink_capacity<GrowthPolicy, std::void_t<decltype(GrowthPolicy::ShrinkCapacity(size_t{}, size_t{}, size_t{}))>>
+    : std::true_type {};
+
+}  // namespace detail
+
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+inline constexpr size_t BASE_PAGE_SIZE = 4096;
+inline constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+// Меньшие части массовых операций не окупают запуск потока
+inline constexpr size_t PARALLEL_MIN_CHUNK_BYTES = 256 * 1024;
+
+// Аллокатор поверх malloc/free с поддержкой reallocate через realloc.
+// realloc расширяет блок на месте, если за ним есть свободная память, а крупные блоки,
+// которые glibc выделяет через mmap, переотображает при помощи mremap без копирования страниц
+template <typename T>
+struct MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not guarantee the alignment of T");
+
+    using value_type = T;
+
+    MallocAllocator() noexcept = default;
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return Checked(std::malloc(Bytes(n)));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    // При ошибке выбрасывает std::bad_alloc, исходный блок при этом остаётся действительным
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        return Checked(std::realloc(static_cast<void*>(p), Bytes(new_n)));
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    static size_t Bytes(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static T* Checked(void* p) {
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+};
+
+// Аллокатор, выравнивающий буфер по границе Alignment байт (не меньше alignof(T), не больше страницы)
+// через выровненные operator new/delete. Выравнивание по CACHE_LINE_SIZE позволяет векторизованным
+// алгоритмам читать буфер целыми кэш-линиями. С PadToAlignment размер блока округляется вверх
+// до кратного Alignment, и буфер не делит кэш-линий с другими данными: так стоит выделять векторы,
+// в которые пишут разные потоки
+template <typename T, size_t Alignment = alignof(T), bool PadToAlignment = false>
+struct AlignedAllocator {
+    static constexpr size_t ALIGNMENT = std::max(Alignment, alignof(T));
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(ALIGNMENT <= BASE_PAGE_SIZE, "alignment must not exceed the page size");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, PadToAlignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, PadToAlignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(Bytes(n), std::align_val_t{ALIGNMENT}));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(static_cast<void*>(p), Bytes(n), std::align_val_t{ALIGNMENT});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment, PadToAlignment>& /*other*/) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment, PadToAlignment>& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    static size_t Bytes(size_t n) {
+        if (n > (SIZE_MAX - ALIGNMENT) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if constexpr (PadToAlignment) {
+            return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        } else {
+            return bytes;
+        }
+    }
+};
+
+namespace detail {
+
+// Владелец чужого буфера, принятого RawMemory: освобождает его вместо аллокатора
+template <typename T>
+class BufferOwner {
 public:
+    virtual ~BufferOwner() = default;
+    virtual void Free(T* buffer, size_t capacity) noexcept = 0;
+};
+
+template <typename T, typename Deleter>
+class DeleterBufferOwner final : public BufferOwner<T> {
+public:
+    explicit DeleterBufferOwner(Deleter deleter)
+        : deleter_(std::move(deleter)) {
+    }
+
+    void Free(T* buffer, size_t capacity) noexcept override {
+        deleter_(buffer, capacity);
+    }
+
+private:
+    Deleter deleter_;
+};
+
+}  // namespace detail
+
+// Буфер сырой памяти под capacity элементов типа T.
+// Память выделяется и освобождается аллокатором Allocator, который хранится вместе с буфером
+// (пустые аллокаторы вроде std::allocator места не занимают). Принятый чужой буфер освобождается
+// его удалителем, а не аллокатором
+template <typename T, typename Allocator = std::allocator<T>>
+class RawMemory : private Allocator {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    using allocator_type = Allocator;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
+    ADVANCED_VECTOR_CONSTEXPR explicit RawMemory(const Allocator& alloc) noexcept
+        : Allocator(alloc) {
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : Allocator(alloc)
+        , buffer_(Allocate(capacity))
+        , capacity_(capacity) {
+    }
+    
+    // Принимает буфер, выделенный аллокатором alloc
+    ADVANCED_VECTOR_CONSTEXPR RawMemory(T* buffer, size_t capacity, const Allocator& alloc) noexcept
+        : Allocator(alloc)
+        , buffer_(buffer)
+        , capacity_(capacity) {
+    }
+
+    // Принимает чужой буфер, который освободит вызов deleter(buffer, capacity). Если владельца
+    // не удалось создать, выбрасывает исключение, и буфер остаётся у вызывающего
+    template <typename Deleter>
+    RawMemory(T* buffer, size_t capacity, Deleter deleter, const Allocator& alloc)
+        : Allocator(alloc)
+        , owner_(new detail::DeleterBufferOwner<T, Deleter>(std::move(deleter)))
+        , buffer_(buffer)
         , capacity_(capacity) {
     }
     
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
-    RawMemory(RawMemory&& other) noexcept
-        : buffer_(nullptr)
-        , capacity_(0) {
-            Swap(other);
+    ADVANCED_VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+        : Allocator(other.GetAllocator())
+        , owner_(std::exchange(other.owner_, nullptr))
+        , buffer_(std::exchange(other.buffer_, nullptr))
+        , capacity_(std::exchange(other.capacity_, 0)) {
     }
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
+    // Освобождает свой буфер и забирает буфер rhs вместе с его аллокатором
+    ADVANCED_VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            Swap(rhs);
+            Deallocate(buffer_, capacity_);
+            static_cast<Allocator&>(*this) = rhs.GetAllocator();
+            owner_ = std::exchange(rhs.owner_, nullptr);
+            buffer_ = std::exchange(rhs.buffer_, nullptr);
+            capacity_ = std::exchange(rhs.capacity_, 0);
         }
         return *this;
     }
 
-    ~RawMemory() {
-        Deallocate(buffer_);
+    ADVANCED_VECTOR_CONSTEXPR ~RawMemory() {
+        Deallocate(buffer_, capacity_);
     }
 
-    T* operator+(size_t offset) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
-        return const_cast<RawMemory&>(*this) + offset;
+    ADVANCED_VECTOR_CONSTEXPR const T* operator+(size_t offset) const noexcept {
+        return const_cast<RawMemory&>(*this) + offset;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
+        return const_cast<RawMemory&>(*this)[index];
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
+     //   assert(index < capacity_);
+        return buffer_[index];
+    }
+
+    // Аллокаторы обмениваются, только если они распространяются при обмене (propagate_on_container_swap),
+    // иначе обмен определён лишь для буферов с равными аллокаторами
+    ADVANCED_VECTOR_CONSTEXPR void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value && !AllocTraits::is_always_equal::value) {
+            using std::swap;
+            swap(static_cast<Allocator&>(*this), static_cast<Allocator&>(other));
+        } else if constexpr (!AllocTraits::is_always_equal::value) {
+            assert(GetAllocator() == other.GetAllocator());
+        }
+        std::swap(owner_, other.owner_);
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    // Отдаёт буфер вызывающему, не освобождая его; RawMemory остаётся пустым. Чужой буфер
+    // возвращается без вызова удалителя
+    ADVANCED_VECTOR_CONSTEXPR T* Release() noexcept {
+        delete std::exchange(owner_, nullptr);
+        capacity_ = 0;
+        return std::exchange(buffer_, nullptr);
+    }
+
+    // Буфер принят вместе с удалителем и не может быть освобождён или перевыделен аллокатором
+    ADVANCED_VECTOR_CONSTEXPR bool IsForeign() const noexcept {
+        return owner_ != nullptr;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const T* GetAddress() const noexcept {
+        return buffer_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR T* GetAddress() noexcept {
+        return buffer_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR size_t Capacity() const {
+        return capacity_;
+    }
+
+    ADVANCED_VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return *this;
+    }
+
+    // Изменяет вместимость при помощи Allocator::reallocate, который может расширить блок на месте.
+    // Содержимое переносится побайтово, поэтому метод применим только к тривиально переносимым типам
+    void Reallocate(size_t new_capacity) {
+        if (IsForeign()) {
+            // Чужой буфер переносится в память аллокатора
+            RawMemory new_data(new_capacity, GetAllocator());
+            std::memcpy(static_cast<void*>(new_data.buffer_), static_cast<const void*>(buffer_),
+                        std::min(capacity_, new_capacity) * sizeof(T));
+            Swap(new_data);
+            return;
+        }
+        buffer_ = static_cast<Allocator&>(*this).reallocate(buffer_, capacity_, new_capacity);
+#if defined(ADVANCED_VECTOR_STATS)
+        detail::Record_Reallocation(capacity_ * sizeof(T), new_capacity * sizeof(T));
+#endif
+        capacity_ = new_capacity;
+    }
+
+private:
+    // Выделяет сырую память под n элементов и возвращает указатель на неё
+    ADVANCED_VECTOR_CONSTEXPR T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T* buf = AllocTraits::allocate(*this, n);
+#if defined(ADVANCED_VECTOR_STATS)
+        if (!detail::Is_Constant_Evaluated()) {
+            detail::Record_Allocation(n * sizeof(T));
+        }
+#endif
+        return buf;
+    }
+
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate
+    ADVANCED_VECTOR_CONSTEXPR void Deallocate(T* buf, size_t n) noexcept {
+        if (owner_ != nullptr) {
+            if (buf != nullptr) {
+                owner_->Free(buf, n);
+            }
+            delete std::exchange(owner_, nullptr);
+            return;
+        }
+        if (buf != nullptr) {
+#if defined(ADVANCED_VECTOR_STATS)
+            if (!detail::Is_Constant_Evaluated()) {
+                detail::Record_Deallocation(n * sizeof(T));
+            }
+#endif
+            AllocTraits::deallocate(*this, buf, n);
+        }
+    }
+
+    // Удалитель принятого чужого буфера; nullptr, если буфер выделен аллокатором. Обычный указатель,
+    // а не unique_ptr, потому что деструктор unique_ptr в C++20 не constexpr
+    detail::BufferOwner<T>* owner_ = nullptr;
+    T* buffer_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+namespace detail {
+
+// Переносит size элементов в неинициализированную память new_begin перемещением,
+// если оно не выбрасывает исключений (или копирование недоступно), иначе копированием
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void Uninitialized_Move_Or_Copy_N(T* begin, size_t size, T* new_begin) {
+    if (Is_Constant_Evaluated()) {
+        for (size_t i = 0; i < size; ++i) {
+            Construct_At(new_begin + i, std::move_if_noexcept(begin[i]));
+        }
+        return;
+    }
+    // constexpr оператор if будет вычислен во время компиляции
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+        std::uninitialized_move_n(begin, size, new_begin);
+    } else {
+        std::uninitialized_copy_n(begin, size, new_begin);
+    }
+}
+
+// Переносит size элементов в неинициализированную память new_begin и разрушает исходные
+template <typename T>
+ADVANCED_VECTOR_CONSTEXPR void Relocate_N(T* begin, size_t size, T* new_begin) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!Is_Constant_Evaluated()) {
+            if (size != 0) {
+                std::memcpy(static_cast<void*>(new_begin), static_cast<const void*>(begin), size * sizeof(T));
+            }
+            return;
+        }
+    }
+    Uninitialized_Move_Or_Copy_N(begin, size, new_begin);
+    Destroy_N(begin, size);
+}
+
+// Признак итератора: для него определена категория в std::iterator_traits
+template <typename It, typename = void>
+struct is_iterator : std::false_type {};
+
+template <typename It>
+struct is_iterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>> : std::true_type {};
+
+template <typename It>
+inline constexpr bool is_forward_iterator_v
+    = std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>;
+
+// Источник элементов для массовой вставки: диапазон, начинающийся с first.
+// Если диапазон задан указателями на тривиально копируемый T, элементы копируются memcpy
+template <typename T, typename ForwardIt>
+struct RangeSource {
+    static constexpr bool IS_CONTIGUOUS_TRIVIAL = std::is_trivially_copyable_v<T> && std::is_pointer_v<ForwardIt>
+        && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<ForwardIt>>, T>;
+
+    // Создаёт n элементов диапазона, начиная с offset-го, в неинициализированной памяти dst
+    void Construct(T* dst, size_t offset, size_t n) const {
+        if constexpr (IS_CONTIGUOUS_TRIVIAL) {
+            if (n != 0) {
+                std::memcpy(dst, first + offset, n * sizeof(T));
+            }
+        } else {
+            std::uninitialized_copy_n(std::next(first, offset), n, dst);
+        }
+    }
+
+    // Присваивает n элементов диапазона, начиная с offset-го, существующим элементам dst
+    void Assign(T* dst, size_t offset, size_t n) const {
+        if constexpr (IS_CONTIGUOUS_TRIVIAL) {
+            if (n != 0) {
+                std::memcpy(dst, first + offset, n * sizeof(T));
+            }
+        } else {
+            std::copy_n(std::next(first, offset), n, dst);
+        }
+    }
+
+    ForwardIt first;
+};
+
+// Источник элементов для массовой вставки: копии одного значения
+template <typename T>
+struct FillSource {
+    void Construct(T* dst, size_t /*offset*/, size_t n) const {
+        std::uninitialized_fill_n(dst, n, value);
+    }
+
+    void Assign(T* dst, size_t /*offset*/, size_t n) const {
+        std::fill_n(dst, n, value);
+    }
+
+    const T& value;
+};
+
+}  // namespace detail
+
+// Политики роста вместимости при автоматическом расширении вектора (PushBack, EmplaceBack, Emplace, Insert).
+// Политика — тип со статическим методом NextCapacity(capacity, required, element_size), который возвращает
+// новую вместимость не меньше required. Явный Reserve политикой не округляется.
+// Политика может также определить ShrinkCapacity(capacity, size, element_size): тогда после PopBack,
+// Erase, EraseIf и уменьшающего Resize вектор сжимается до возвращённой вместимости, если она меньше текущей
+
+// Рост в Numerator / Denominator раза, но не меньше чем до required
+template <size_t Numerator, size_t Denominator>
+struct FactorGrowth {
+    static_assert(Numerator > Denominator && Denominator > 0, "growth factor must be greater than 1");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        const size_t grown = capacity > SIZE_MAX / Numerator ? SIZE_MAX : capacity * Numerator / Denominator;
+        return std::max(grown, required);
+    }
+};
+
+using DoublingGrowth = FactorGrowth<2, 1>;
+using OneAndHalfGrowth = FactorGrowth<3, 2>;
+
+// Первое выделение занимает не меньше MinBytes байт (по умолчанию одну кэш-линию)
+template <typename BasePolicy, size_t MinBytes = CACHE_LINE_SIZE>
+struct MinInitialCapacity {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = BasePolicy::NextCapacity(capacity, required, element_size);
+        if (capacity != 0) {
+            return next;
+        }
+        return std::max(next, (MinBytes + element_size - 1) / element_size);
+    }
+};
+
+// Вместимость за один шаг растёт не больше чем на MaxStepBytes байт, что ограничивает
+// неиспользуемый запас у очень больших векторов
+template <typename BasePolicy, size_t MaxStepBytes = 64 * 1024 * 1024>
+struct CappedGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = BasePolicy::NextCapacity(capacity, required, element_size);
+        const size_t max_step = std::max<size_t>(MaxStepBytes / element_size, 1);
+        return std::max(std::min(next, capacity + max_step), required);
+    }
+};
+
+// Округляет размер буфера вверх до класса размеров типичного аллокатора (jemalloc, tcmalloc):
+// 16 байт для маленьких блоков, далее четыре класса на каждую степень двойки.
+// Память, которую аллокатор всё равно выделил бы при округлении, становится вместимостью вектора
+template <typename BasePolicy>
+struct SizeClassRounding {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = BasePolicy::NextCapacity(capacity, required, element_size);
+        if (next > SIZE_MAX / element_size / 2) {
+            return next;
+        }
+        return RoundBytes(next * element_size) / element_size;
+    }
+
+private:
+    static constexpr size_t RoundBytes(size_t bytes) noexcept {
+        if (bytes <= 16) {
+            return 16;
+        }
+        size_t power = 16;
+        while (power * 2 < bytes) {
+            power *= 2;
+        }
+        const size_t spacing = std::max<size_t>(power / 4, 16);
+        return (bytes + spacing - 1) / spacing * spacing;
+    }
+};
+
+// Буферы от Threshold байт округляются до целого числа огромных страниц по 2 МБ,
+// чтобы хвост последней страницы не пропадал
+template <typename BasePolicy, size_t Threshold = HUGE_PAGE_SIZE>
+struct HugePageRounding {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t next = BasePolicy::NextCapacity(capacity, required, element_size);
+        if (next < Threshold / element_size || next > SIZE_MAX / element_size - HUGE_PAGE_SIZE) {
+            return next;
+        }
+        const size_t bytes = (next * element_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        return bytes / element_size;
+    }
+};
+
+// Сжатие с гистерезисом: когда размер падает ниже capacity / Divisor, вместимость уменьшается до удвоенного
+// размера (с округлением BasePolicy). Новый рост начнётся только после удвоения размера, а следующее
+// сжатие — после его уменьшения вдвое, поэтому чередование добавлений и удалений не перевыделяет буфер
+// на каждой операции. Clear буфер не сжимает: он предназначен для повторного заполнения
+template <typename BasePolicy, size_t Divisor = 4>
+struct HysteresisShrink {
+    static_assert(Divisor > 2, "shrinking to twice the size must leave room before the next shrink");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        return BasePolicy::NextCapacity(capacity, required, element_size);
+    }
+
+    static constexpr size_t ShrinkCapacity(size_t capacity, size_t size, size_t element_size) noexcept {
+        // size * Divisor >= capacity без переполнения
+        if (size >= capacity / Divisor + (capacity % Divisor != 0 ? 1 : 0)) {
+            return capacity;
+        }
+        return std::min(capacity, BasePolicy::NextCapacity(0, size * 2, element_size));
+    }
+};
+
+// Политика параллельного выполнения массовых операций Vector: создания, копирования, Reserve и Clear.
+// Стандартный <execution> не используется, потому что libstdc++ связывает его с TBB
+namespace execution {
+
+struct ParallelPolicy {
+    // Наибольшее число потоков; 0 — std::thread::hardware_concurrency()
+    size_t num_threads = 0;
+};
+
+inline constexpr ParallelPolicy par{};
+
+}  // namespace execution
+
+namespace detail {
+
+inline size_t Num_Chunks(const execution::ParallelPolicy& policy, size_t count, size_t element_size) noexcept {
+    const size_t num_threads = policy.num_threads != 0 ? policy.num_threads
+                                                       : std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t min_chunk = std::max<size_t>(1, PARALLEL_MIN_CHUNK_BYTES / element_size);
+    return std::clamp<size_t>(count / min_chunk, 1, num_threads);
+}
+
+// Начало части index из num_chunks почти равных частей [0, count)
+inline size_t Chunk_Begin(size_t count, size_t num_chunks, size_t index) noexcept {
+    return count / num_chunks * index + std::min(index, count % num_chunks);
+}
+
+// Выполняет fn(index, first, last) для каждой части index из num_chunks частей [0, count): первую —
+// в вызывающем потоке, остальные — в отдельных. Часть, для которой не удалось создать поток,
+// выполняется в вызывающем потоке. fn не должна выбрасывать исключений
+template <typename Fn>
+void Parallel_For_Chunks(size_t count, size_t num_chunks, const Fn& fn) noexcept {
+    const auto run = [&fn, count, num_chunks](size_t index) noexcept {
+        fn(index, Chunk_Begin(count, num_chunks, index), Chunk_Begin(count, num_chunks, index + 1));
+    };
+    std::unique_ptr<std::thread[]> threads(num_chunks > 1 ? new (std::nothrow) std::thread[num_chunks - 1] : nullptr);
+    for (size_t i = 1; i < num_chunks; ++i) {
+        if (threads == nullptr) {
+            run(i);
+            continue;
+        }
+        try {
+            threads[i - 1] = std::thread(run, i);
+        } catch (...) {
+            run(i);
+        }
+    }
+    run(0);
+    for (size_t i = 1; threads != nullptr && i < num_chunks; ++i) {
+        if (threads[i - 1].joinable()) {
+            threads[i - 1].join();
+        }
+    }
+}
+
+// Параллельно выполняет fn(first, last), которая не выбрасывает исключений, для частей [0, count)
+// элементов размера element_size
+template <typename Fn>
+void Parallel_For(const execution::ParallelPolicy& policy, size_t count, size_t element_size, Fn fn) noexcept {
+    Parallel_For_Chunks(count, Num_Chunks(policy, count, element_size), [&fn](size_t /*index*/, size_t first, size_t last) {
+        fn(first, last);
+    });
+}
+
+// Параллельно создаёт элементы [0, count): construct(first, last) создаёт элементы части либо выбрасывает
+// исключение, ничего не оставив. Если хоть одна часть не создана, успешно созданные части разрушаются
+// вызовом destroy(first, last), а исключение части с наименьшим номером выбрасывается дальше
+template <typename Construct, typename Destroy>
+void Parallel_Construct(const execution::ParallelPolicy& policy, size_t count, size_t element_size,
+                        Construct construct, Destroy destroy) {
+    const size_t num_chunks = Num_Chunks(policy, count, element_size);
+    if (num_chunks == 1) {
+        construct(size_t{0}, count);
+        return;
+    }
+    // Каждая часть пишет только в свою ячейку
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[num_chunks]);
+    Parallel_For_Chunks(count, num_chunks, [&](size_t index, size_t first, size_t last) noexcept {
+        try {
+            construct(first, last);
+        } catch (...) {
+            errors[index] = std::current_exception();
+        }
+    });
+    const auto failed = std::find_if(&errors[0], &errors[0] + num_chunks, [](const std::exception_ptr& error) {
+        return error != nullptr;
+    });
+    if (failed == &errors[0] + num_chunks) {
+        return;
+    }
+    for (size_t i = 0; i < num_chunks; ++i) {
+        if (errors[i] == nullptr) {
+            destroy(Chunk_Begin(count, num_chunks, i), Chunk_Begin(count, num_chunks, i + 1));
+        }
+    }
+    std::rethrow_exception(*failed);
+}
+
+}  // namespace detail
+
+namespace detail {
+
+// Итератор произвольного доступа по индексу для контейнеров, элементы которых не лежат одним
+// массивом. Разыменование вызывает operator[] контейнера, поэтому итератор остаётся действительным,
+// пока жив сам контейнер и индекс меньше его размера
+template <typename Container, bool IsConst>
+class IndexIterator {
+    using ContainerPtr = std::conditional_t<IsConst, const Container*, Container*>;
+    using Value = typename Container::value_type;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Value;
+    using difference_type = ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const Value*, Value*>;
+    using reference = std::conditional_t<IsConst, const Value&, Value&>;
+
+    IndexIterator() = default;
+
+    IndexIterator(ContainerPtr container, size_t index) noexcept
+        : container_(container)
+        , index_(index) {
+    }
+
+    // iterator приводится к const_iterator
+    template <bool OtherIsConst, typename = std::enable_if_t<IsConst && !OtherIsConst>>
+    IndexIterator(const IndexIterator<Container, OtherIsConst>& other) noexcept
+        : container_(other.container_)
+        , index_(other.index_) {
+    }
+
+    reference operator*() const noexcept {
+        return (*container_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+        return &**this;
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return *(*this + offset);
+    }
+
+    IndexIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    IndexIterator operator++(int) noexcept {
+        IndexIterator old = *this;
+        ++index_;
+        return old;
+    }
+
+    IndexIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    IndexIterator operator--(int) noexcept {
+        IndexIterator old = *this;
+        --index_;
+        return old;
+    }
+
+    IndexIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    IndexIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend IndexIterator operator+(IndexIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend IndexIterator operator+(difference_type offset, IndexIterator it) noexcept {
+        return it += offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
-        return const_cast<RawMemory&>(*this)[index];
+    friend IndexIterator operator-(IndexIterator it, difference_type offset) noexcept {
+        return it -= offset;
     }
 
-    T& operator[](size_t index) noexcept {
-     //   assert(index < capacity_);
-        return buffer_[index];
+    friend difference_type operator-(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_ - rhs.index_);
     }
 
-    void Swap(RawMemory& other) noexcept {
-        std::swap(buffer_, other.buffer_);
-        std::swap(capacity_, other.capacity_);
+    friend bool operator==(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
     }
 
-    const T* GetAddress() const noexcept {
-        return buffer_;
+    friend bool operator!=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ != rhs.index_;
     }
 
-    T* GetAddress() noexcept {
-        return buffer_;
+    friend bool operator<(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ < rhs.index_;
     }
 
-    size_t Capacity() const {
-        return capacity_;
+    friend bool operator>(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return rhs < lhs;
     }
 
-private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    friend bool operator<=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return !(rhs < lhs);
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    friend bool operator>=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return !(lhs < rhs);
     }
 
-    T* buffer_ = nullptr;
-    size_t capacity_ = 0;
+private:
+    template <typename, bool>
+    friend class IndexIterator;
+
+    ContainerPtr container_ = nullptr;
+    size_t index_ = 0;
 };
 
+}  // namespace detail
+
+// Буфер, отданный вектором методом ReleaseBuffer: первые size из capacity элементов созданы
 template <typename T>
+struct ReleasedBuffer {
+    T* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
 class Vector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
+    using allocator_type = Allocator;
     
     Vector() = default;
-    explicit Vector(size_t size);
-    Vector(const Vector& other);
-    Vector(Vector&& other) noexcept;
+    ADVANCED_VECTOR_CONSTEXPR explicit Vector(const Allocator& alloc) noexcept;
+    ADVANCED_VECTOR_CONSTEXPR explicit Vector(size_t size, const Allocator& alloc = Allocator());
+    // Элементы создаются параллельно частями; если создание какой-то части выбросило исключение,
+    // разрушаются только уже созданные части
+    Vector(execution::ParallelPolicy policy, size_t size, const Allocator& alloc = Allocator());
+    ADVANCED_VECTOR_CONSTEXPR Vector(const Vector& other);
+    Vector(execution::ParallelPolicy policy, const Vector& other);
+    ADVANCED_VECTOR_CONSTEXPR Vector(const Vector& other, const Allocator& alloc);
+    ADVANCED_VECTOR_CONSTEXPR Vector(Vector&& other) noexcept;
+    ADVANCED_VECTOR_CONSTEXPR Vector(Vector&& other, const Allocator& alloc);
     
-    ~Vector();
+    ADVANCED_VECTOR_CONSTEXPR ~Vector();
+
+    // Принимает буфер data на capacity элементов, первые size из которых уже созданы.
+    // Буфер должен быть выделен аллокатором alloc
+    static Vector FromRawBuffer(T* data, size_t size, size_t capacity, const Allocator& alloc = Allocator()) noexcept;
+    // Принимает чужой буфер: когда вектор от него откажется, элементы будут разрушены, а буфер
+    // освободит вызов deleter(data, capacity). При исключении буфер остаётся у вызывающего
+    template <typename Deleter>
+    static Vector FromRawBuffer(T* data, size_t size, size_t capacity, Deleter deleter,
+                                const Allocator& alloc = Allocator());
+    // Отдаёт буфер вместе с элементами без их разрушения и копирования, вектор становится пустым.
+    // Вызывающий разрушает элементы и освобождает буфер аллокатором вектора, а буфер, принятый
+    // с удалителем, — так же, как до FromRawBuffer
+    ReleasedBuffer<T> ReleaseBuffer() noexcept;
     
     using iterator = T*;
         using const_iterator = const T*;
         
-        iterator begin() noexcept;
-        iterator end() noexcept;
-        const_iterator begin() const noexcept;
-        const_iterator end() const noexcept;
-        const_iterator cbegin() const noexcept;
-        const_iterator cend() const noexcept;
-
-    Vector& operator=(const Vector& rhs) {
+        ADVANCED_VECTOR_CONSTEXPR iterator begin() noexcept;
+        ADVANCED_VECTOR_CONSTEXPR iterator end() noexcept;
+        ADVANCED_VECTOR_CONSTEXPR const_iterator begin() const noexcept;
+        ADVANCED_VECTOR_CONSTEXPR const_iterator end() const noexcept;
+        ADVANCED_VECTOR_CONSTEXPR const_iterator cbegin() const noexcept;
+        ADVANCED_VECTOR_CONSTEXPR const_iterator cend() const noexcept;
+
+    ADVANCED_VECTOR_CONSTEXPR Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
+            Stats_Record_Peak();
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value
+                          && !AllocTraits::is_always_equal::value) {
+                if (data_.GetAllocator() != rhs.data_.GetAllocator()) {
+                    /* Память, выделенная текущим аллокатором, не может остаться у аллокатора rhs */
+                    Vector rhs_copy(rhs, rhs.data_.GetAllocator());
+                    detail::Destroy_N(data_.GetAddress(), size_);
+                    data_ = std::move(rhs_copy.data_);
+                    size_ = std::exchange(rhs_copy.size_, 0);
+                    return *this;
+                }
+            }
             if (rhs.Size() > data_.Capacity()) {
                 /* Применить copy-and-swap */
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
+                Vector rhs_copy(rhs, data_.GetAllocator());
+                SwapStorage(rhs_copy);
             } else {
                 /* Скопировать элементы из rhs, создав при необходимости новые
                    или удалив существующие */
@@ -126,7 +1040,7 @@ public:
                     }
                 }
                 if (rhs.Size() > size_) {
-                    std::uninitialized_copy_n(rhs.data_.GetAddress() + size_, rhs.Size() - size_, data_.GetAddress() + size_);
+                    detail::Uninitialized_Copy_N(rhs.data_.GetAddress() + size_, rhs.Size() - size_, data_.GetAddress() + size_);
                 }
             }
             size_ = rhs.Size();
@@ -134,277 +1048,998 @@ public:
         return *this;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
-        Swap(rhs);
+    ADVANCED_VECTOR_CONSTEXPR Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value) {
+        if constexpr (AllocTraits::is_always_equal::value) {
+            SwapStorage(rhs);
+        } else if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            if (this != &rhs) {
+                Stats_Record_Peak();
+                rhs.Stats_Record_Peak();
+                detail::Destroy_N(data_.GetAddress(), size_);
+                data_ = std::move(rhs.data_);
+                size_ = std::exchange(rhs.size_, 0);
+            }
+        } else if (data_.GetAllocator() == rhs.data_.GetAllocator()) {
+            SwapStorage(rhs);
+        } else if (this != &rhs) {
+            /* Аллокаторы не распространяются и не равны: буфер rhs забрать нельзя,
+               поэтому элементы перемещаются в память текущего аллокатора */
+            Vector rhs_moved(std::move(rhs), data_.GetAllocator());
+            SwapStorage(rhs_moved);
+        }
         return *this;
     }
     
-    const T& operator[](size_t index) const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    ADVANCED_VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < size_);
         return data_[index];
     }
     
-    size_t Size() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR size_t Size() const noexcept {
         return size_;
     }
 
-    size_t Capacity() const noexcept {
+    ADVANCED_VECTOR_CONSTEXPR size_t Capacity() const noexcept {
         return data_.Capacity();
     }
+
+    ADVANCED_VECTOR_CONSTEXPR Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+#if defined(ADVANCED_VECTOR_STATS)
+    VectorInstanceStats Stats() const noexcept {
+        VectorInstanceStats stats = stats_;
+        stats.peak_size = std::max(stats.peak_size, size_);
+        stats.peak_capacity = std::max(stats.peak_capacity, data_.Capacity());
+        return stats;
+    }
+#endif
     
-    void Reserve(size_t new_capacity);
-    void Swap(Vector& other) noexcept;
-    void Resize(size_t new_size);
-    void PushBack(const T& value);
-    void PushBack(T&& value);
-    void PopBack() /* noexcept */;
+    ADVANCED_VECTOR_CONSTEXPR void Reserve(size_t new_capacity);
+    // Элементы переносятся в новый буфер параллельно; при исключении вектор не изменяется
+    void Reserve(execution::ParallelPolicy policy, size_t new_capacity);
+    // Уменьшает вместимость до max(new_capacity, Size()), возвращая память аллокатору. Тривиально
+    // переносимые элементы сжимаются через Allocator::reallocate, если он есть; при исключении
+    // вектор не изменяется
+    ADVANCED_VECTOR_CONSTEXPR void ShrinkTo(size_t new_capacity);
+    ADVANCED_VECTOR_CONSTEXPR void ShrinkToFit();
+    ADVANCED_VECTOR_CONSTEXPR void Swap(Vector& other) noexcept;
+    // Разрушает элементы и сохраняет вместимость, даже если политика роста сжимает вектор после удалений:
+    // буфер остаётся для повторного заполнения без выделений. Память возвращают ShrinkToFit и ShrinkTo
+    ADVANCED_VECTOR_CONSTEXPR void Clear() noexcept;
+    void Clear(execution::ParallelPolicy policy) noexcept;
+    ADVANCED_VECTOR_CONSTEXPR void Resize(size_t new_size);
+    // Как Resize, но новые элементы инициализируются по умолчанию: тривиальные типы остаются
+    // неинициализированными, что избавляет буферы ввода-вывода от лишнего обнуления
+    void ResizeDefaultInit(size_t new_size);
+    // Увеличивает размер на count неинициализированных элементов и возвращает их для заполнения.
+    // Вместимость растёт по GrowthPolicy, как при PushBack
+    Span<T> AppendUninitialized(size_t count);
+    // Раздвигает элементы перед pos на count неинициализированных элементов и возвращает их для заполнения.
+    // Хвост переносится один раз: memmove для тривиально переносимых типов, иначе перемещающим конструктором
+    // (он не должен выбрасывать исключений). Вместимость растёт по GrowthPolicy, как при Insert
+    Span<T> OpenGap(const_iterator pos, size_t count);
+    ADVANCED_VECTOR_CONSTEXPR void PushBack(const T& value);
+    ADVANCED_VECTOR_CONSTEXPR void PushBack(T&& value);
+    ADVANCED_VECTOR_CONSTEXPR void PopBack() /* noexcept */;
     
     template <typename... Args>
-    T& EmplaceBack(Args&&... args);
+    ADVANCED_VECTOR_CONSTEXPR T& EmplaceBack(Args&&... args);
     
+    // Хвост сдвигается переносом, и элемент создаётся сразу на своём месте. Если аргумент — ссылка
+    // на сдвигаемый элемент вектора, элемент сначала создаётся во временном объекте. Указатели и итераторы
+    // на элементы внутри аргументов не отслеживаются: передавайте сами элементы по ссылке
+    template <typename... Args>
+    ADVANCED_VECTOR_CONSTEXPR iterator Emplace(const_iterator pos, Args&&... args);
+    // Как Emplace, но по индексу и возвращает ссылку на элемент, как EmplaceBack
     template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args);
-    iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/;
-    iterator Insert(const_iterator pos, const T& value);
-    iterator Insert(const_iterator pos, T&& value);
+    ADVANCED_VECTOR_CONSTEXPR T& EmplaceAt(size_t index, Args&&... args);
+    ADVANCED_VECTOR_CONSTEXPR iterator Erase(const_iterator pos) /*noexcept(std::is_nothrow_move_assignable_v<T>)*/;
+    ADVANCED_VECTOR_CONSTEXPR iterator Insert(const_iterator pos, const T& value);
+    ADVANCED_VECTOR_CONSTEXPR iterator Insert(const_iterator pos, T&& value);
+
+    // Удаляет элементы [first, last): хвост сдвигается один раз
+    ADVANCED_VECTOR_CONSTEXPR iterator Erase(const_iterator first, const_iterator last);
+    // Удаляет элементы, удовлетворяющие pred, за один проход с уплотнением; оставшийся хвост
+    // разрушается одним destroy_n. Возвращает количество удалённых элементов
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred);
+
+    // Массовая вставка: итоговый размер вычисляется заранее, буфер перевыделяется не больше одного раза,
+    // хвост сдвигается один раз. Для однопроходных итераторов элементы добавляются в конец и поворачиваются
+    template <typename InputIt, typename = std::enable_if_t<detail::is_iterator<InputIt>::value>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last);
+    iterator Insert(const_iterator pos, size_t count, const T& value);
+    template <typename InputIt, typename = std::enable_if_t<detail::is_iterator<InputIt>::value>>
+    void Append(InputIt first, InputIt last);
+    // Копии элементов представления; оно может указывать на элементы самого вектора
+    iterator Insert(const_iterator pos, ConstSpan<T> values);
+    void Append(ConstSpan<T> values);
+    template <typename Range>
+    void AppendRange(const Range& range);
 
 private:
-    RawMemory<T> data_;
+    // Буфер растёт через Allocator::reallocate (на месте, без выделения нового блока и копирования)
+    static constexpr bool REALLOCATES_IN_PLACE = is_trivially_relocatable_v<T> && detail::has_reallocate<Allocator>::value;
+
+    RawMemory<T, Allocator> data_;
     size_t size_ = 0;
+#if defined(ADVANCED_VECTOR_STATS)
+    VectorInstanceStats stats_{sizeof(T)};
+#endif
+
+    // Учитывает в статистике перевыделение буфера: вызывается сразу после смены буфера, пока size_
+    // равен числу перенесённых элементов
+    ADVANCED_VECTOR_CONSTEXPR void Stats_Reallocated() noexcept {
+#if defined(ADVANCED_VECTOR_STATS)
+        ++stats_.reallocations;
+        stats_.relocated_elements += size_;
+        Stats_Record_Peak();
+#endif
+    }
+    // Запоминает пиковые размер и вместимость; вызывается перед операциями, которые могут их уменьшить
+    ADVANCED_VECTOR_CONSTEXPR void Stats_Record_Peak() noexcept {
+#if defined(ADVANCED_VECTOR_STATS)
+        stats_.peak_size = std::max(stats_.peak_size, size_);
+        stats_.peak_capacity = std::max(stats_.peak_capacity, data_.Capacity());
+#endif
+    }
     
-    void Uninitialized_Move_Or_Copy_N(iterator begin, size_t size, iterator new_begin);
+    // Вместимость при автоматическом росте, достаточная для required элементов
+    ADVANCED_VECTOR_CONSTEXPR size_t Next_Capacity(size_t required) const noexcept {
+        return GrowthPolicy::NextCapacity(data_.Capacity(), required, sizeof(T));
+    }
+
+    // Расширяет буфер до new_capacity, если он меньше. Внутренние пути роста вызывают его вместо Reserve,
+    // чтобы reserve_calls считал только явные вызовы
+    ADVANCED_VECTOR_CONSTEXPR void Grow_To(size_t new_capacity);
+    // Сжимает буфер после удаления элементов, если политика роста это предусматривает
+    ADVANCED_VECTOR_CONSTEXPR void Auto_Shrink() noexcept;
+    // Хвост переносится без исключений: memmove или перемещающий конструктор noexcept
+    static constexpr bool RELOCATES_NOTHROW = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+    // Вставка тривиально переносимого элемента: при нехватке вместимости буфер расширяется через
+    // Allocator::reallocate, хвост сдвигается одним memmove, элемент создаётся на своём месте
+    template <typename... Args>
+    iterator Emplace_Relocating(size_t pos_num, Args&&... args);
+    // Указывает ли какой-либо из аргументов, переданных по ссылке, на элементы [first, end())
+    template <typename... Args>
+    bool Args_Alias(const T* first, const Args&... args) const noexcept;
+    // Переносит хвост [pos_num, size_) на count позиций вправо в пределах вместимости; на месте
+    // [pos_num, pos_num + count) остаётся неинициализированная память, size_ не изменяется
+    ADVANCED_VECTOR_CONSTEXPR void Open_Gap(size_t pos_num, size_t count) noexcept;
+    // Возвращает на место хвост, сдвинутый Open_Gap, закрывая неинициализированный промежуток
+    ADVANCED_VECTOR_CONSTEXPR void Close_Empty_Gap(size_t pos_num, size_t count) noexcept;
+    // Вставляет count элементов из source (detail::RangeSource или detail::FillSource) в позицию pos_num.
+    // Source не должен ссылаться на элементы вектора
+    template <typename Source>
+    iterator Insert_From(size_t pos_num, size_t count, const Source& source);
+    // Пересекается ли диапазон адресов [first, last) с элементами вектора
+    bool Overlaps(const T* first, const T* last) const noexcept {
+        return std::less<const T*>()(first, end()) && std::less<const T*>()(begin(), last);
+    }
+    // Удаляет count элементов с позиции first, сдвигая на их место хвост; size_ не изменяется.
+    // Тривиально переносимые элементы сдвигаются одним memmove без присваиваний
+    ADVANCED_VECTOR_CONSTEXPR void Close_Gap(iterator first, size_t count);
+    // Обменивает буферы и размеры; аллокаторы обмениваются по правилам RawMemory::Swap
+    ADVANCED_VECTOR_CONSTEXPR void SwapStorage(Vector& other) noexcept;
+
+    Vector(RawMemory<T, Allocator>&& data, size_t size) noexcept
+        : data_(std::move(data))
+        , size_(size) {
+        assert(size_ <= data_.Capacity());
+    }
 };
 
+namespace pmr {
 
-template <typename T>
-Vector<T>::Vector(size_t size)
-    : data_(size)
+// Вектор, память которого выделяется из std::pmr::memory_resource (например, арены на время запроса).
+// Аллокатор не распространяется при копировании, перемещающем присваивании и Swap
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+
+}  // namespace pmr
+
+// Вектор, буфер которого выровнен по кэш-линии и занимает целое число кэш-линий
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+using CacheAlignedVector = Vector<T, AlignedAllocator<T, CACHE_LINE_SIZE, true>, GrowthPolicy>;
+
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR Vector<T, Allocator, GrowthPolicy>::Vector(const Allocator& alloc) noexcept
+    : data_(alloc) //
+{
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR Vector<T, Allocator, GrowthPolicy>::Vector(size_t size, const Allocator& alloc)
+    : data_(size, alloc)
     , size_(size) //
 {
-    std::uninitialized_value_construct_n(data_.GetAddress(), size);
+    detail::Uninitialized_Value_Construct_N(data_.GetAddress(), size);
 }
 
-template <typename T>
-Vector<T>::~Vector() {
-    std::destroy_n(data_.GetAddress(), size_);
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR Vector<T, Allocator, GrowthPolicy>::~Vector() {
+#if defined(ADVANCED_VECTOR_STATS)
+    if (!detail::Is_Constant_Evaluated()) {
+        if (const VectorStatsCallback callback = detail::stats_callback.load(std::memory_order_acquire)) {
+            callback(Stats());
+        }
+    }
+#endif
+    detail::Destroy_N(data_.GetAddress(), size_);
 }
 
-template <typename T>
-Vector<T>::Vector(const Vector& other)
-    : data_(other.size_)
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR Vector<T, Allocator, GrowthPolicy>::Vector(const Vector& other)
+    : Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) //
+{
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(execution::ParallelPolicy policy, size_t size, const Allocator& alloc)
+    : data_(size, alloc)
+    , size_(size) //
+{
+    T* data = data_.GetAddress();
+    detail::Parallel_Construct(
+        policy, size, sizeof(T),
+        [data](size_t first, size_t last) {
+            std::uninitialized_value_construct_n(data + first, last - first);
+        },
+        [data](size_t first, size_t last) noexcept {
+            std::destroy_n(data + first, last - first);
+        });
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy>::Vector(execution::ParallelPolicy policy, const Vector& other)
+    : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator()))
     , size_(other.size_) //
 {
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+    const T* src = other.data_.GetAddress();
+    T* data = data_.GetAddress();
+    detail::Parallel_Construct(
+        policy, size_, sizeof(T),
+        [src, data](size_t first, size_t last) {
+            std::uninitialized_copy_n(src + first, last - first, data + first);
+        },
+        [data](size_t first, size_t last) noexcept {
+            std::destroy_n(data + first, last - first);
+        });
 }
 
-template <typename T>
-Vector<T>::Vector(Vector&& other) noexcept
-    : data_(0)
-    , size_(0)
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR Vector<T, Allocator, GrowthPolicy>::Vector(const Vector& other, const Allocator& alloc)
+    : data_(other.size_, alloc)
+    , size_(other.size_) //
+{
+    detail::Uninitialized_Copy_N(other.data_.GetAddress(), size_, data_.GetAddress());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR Vector<T, Allocator, GrowthPolicy>::Vector(Vector&& other) noexcept
+    : data_(std::move(other.data_))
+    , size_(std::exchange(other.size_, 0))
 {
-    Swap(other);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR Vector<T, Allocator, GrowthPolicy>::Vector(Vector&& other, const Allocator& alloc)
+    : data_(alloc)
+{
+    if (alloc == other.data_.GetAllocator()) {
+        SwapStorage(other);
+    } else {
+        RawMemory<T, Allocator> new_data(other.size_, alloc);
+        detail::Uninitialized_Move_Or_Copy_N(other.begin(), other.size_, new_data.GetAddress());
+        data_.Swap(new_data);
+        size_ = other.size_;
+    }
 }
 
 //Итераторы
-template <typename T>
-typename Vector<T>::iterator Vector<T>::begin() noexcept {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::begin() noexcept {
     return data_.GetAddress();
 }
 
-template <typename T>
-typename Vector<T>::iterator Vector<T>::end() noexcept {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::end() noexcept {
     return data_.GetAddress() + size_;
 }
 
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::begin() const noexcept {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::const_iterator Vector<T, Allocator, GrowthPolicy>::begin() const noexcept {
     return data_.GetAddress();
 }
 
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::end() const noexcept {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::const_iterator Vector<T, Allocator, GrowthPolicy>::end() const noexcept {
     return data_.GetAddress() + size_;
 }
 
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::cbegin() const noexcept {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::const_iterator Vector<T, Allocator, GrowthPolicy>::cbegin() const noexcept {
     return begin();
 }
 
-template <typename T>
-typename Vector<T>::const_iterator Vector<T>::cend() const noexcept {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::const_iterator Vector<T, Allocator, GrowthPolicy>::cend() const noexcept {
     return end();
 }
 
 //методы
-template <typename T>
-void Vector<T>::Uninitialized_Move_Or_Copy_N(iterator begin, size_t size, iterator new_begin) {
-    // constexpr оператор if будет вычислен во время компиляции
-    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-        std::uninitialized_move_n(begin, size, new_begin);
-    } else {
-        std::uninitialized_copy_n(begin, size, new_begin);
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Reserve(size_t new_capacity) {
+#if defined(ADVANCED_VECTOR_STATS)
+    ++stats_.reserve_calls;
+#endif
+    Grow_To(new_capacity);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Grow_To(size_t new_capacity) {
+    if (new_capacity <= data_.Capacity()) {
+        return;
+    }
+    if constexpr (REALLOCATES_IN_PLACE) {
+        data_.Reallocate(new_capacity);
+        Stats_Reallocated();
+        return;
     }
+    RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+    detail::Relocate_N(data_.GetAddress(), size_, new_data.GetAddress());
+    data_.Swap(new_data);
+    Stats_Reallocated();
 }
 
-template <typename T>
-void Vector<T>::Reserve(size_t new_capacity) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Reserve(execution::ParallelPolicy policy, size_t new_capacity) {
+#if defined(ADVANCED_VECTOR_STATS)
+    ++stats_.reserve_calls;
+#endif
+    if constexpr (REALLOCATES_IN_PLACE) {
+        // Перевыделение на месте не переносит элементы поштучно, делить нечего
+        Grow_To(new_capacity);
+        return;
+    }
     if (new_capacity <= data_.Capacity()) {
         return;
     }
-    RawMemory<T> new_data(new_capacity);
-    Uninitialized_Move_Or_Copy_N(data_.GetAddress(), size_, new_data.GetAddress());
-    std::destroy_n(data_.GetAddress(), size_);
+    RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+    T* src = data_.GetAddress();
+    T* dst = new_data.GetAddress();
+    if constexpr (is_trivially_relocatable_v<T>) {
+        detail::Parallel_For(policy, size_, sizeof(T), [src, dst](size_t first, size_t last) noexcept {
+            detail::Relocate_N(src + first, last - first, dst + first);
+        });
+    } else {
+        // Старые элементы разрушаются только после того, как перенесены все части
+        detail::Parallel_Construct(
+            policy, size_, sizeof(T),
+            [src, dst](size_t first, size_t last) {
+                detail::Uninitialized_Move_Or_Copy_N(src + first, last - first, dst + first);
+            },
+            [dst](size_t first, size_t last) noexcept {
+                std::destroy_n(dst + first, last - first);
+            });
+        detail::Parallel_For(policy, size_, sizeof(T), [src](size_t first, size_t last) noexcept {
+            std::destroy_n(src + first, last - first);
+        });
+    }
+    data_.Swap(new_data);
+    Stats_Reallocated();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::ShrinkTo(size_t new_capacity) {
+    new_capacity = std::max(new_capacity, size_);
+    if (new_capacity >= data_.Capacity()) {
+        return;
+    }
+    Stats_Record_Peak();
+    if (new_capacity == 0) {
+        RawMemory<T, Allocator>(data_.GetAllocator()).Swap(data_);
+        return;
+    }
+    if constexpr (REALLOCATES_IN_PLACE) {
+        data_.Reallocate(new_capacity);
+        Stats_Reallocated();
+        return;
+    }
+    RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+    detail::Relocate_N(data_.GetAddress(), size_, new_data.GetAddress());
     data_.Swap(new_data);
+    Stats_Reallocated();
 }
 
-template <typename T>
-void Vector<T>::Swap(Vector& other) noexcept {
-    std::swap(data_, other.data_);
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::ShrinkToFit() {
+    ShrinkTo(size_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Auto_Shrink() noexcept {
+    if constexpr (detail::has_shrink_capacity<GrowthPolicy>::value) {
+        const size_t new_capacity = GrowthPolicy::ShrinkCapacity(data_.Capacity(), size_, sizeof(T));
+        if (new_capacity < data_.Capacity()) {
+            try {
+                ShrinkTo(new_capacity);
+            } catch (...) {
+                // Сжатие — только подсказка: если новый буфер не удалось выделить, остаётся прежний
+            }
+        }
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+Vector<T, Allocator, GrowthPolicy> Vector<T, Allocator, GrowthPolicy>::FromRawBuffer(T* data, size_t size, size_t capacity,
+                                                                                     const Allocator& alloc) noexcept {
+    return Vector(RawMemory<T, Allocator>(data, capacity, alloc), size);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename Deleter>
+Vector<T, Allocator, GrowthPolicy> Vector<T, Allocator, GrowthPolicy>::FromRawBuffer(T* data, size_t size, size_t capacity,
+                                                                                     Deleter deleter, const Allocator& alloc) {
+    return Vector(RawMemory<T, Allocator>(data, capacity, std::move(deleter), alloc), size);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ReleasedBuffer<T> Vector<T, Allocator, GrowthPolicy>::ReleaseBuffer() noexcept {
+    Stats_Record_Peak();
+    ReleasedBuffer<T> released;
+    released.size = std::exchange(size_, 0);
+    released.capacity = data_.Capacity();
+    released.data = data_.Release();
+    return released;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Clear() noexcept {
+    Stats_Record_Peak();
+    detail::Destroy_N(data_.GetAddress(), size_);
+    size_ = 0;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Clear(execution::ParallelPolicy policy) noexcept {
+    Stats_Record_Peak();
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        T* data = data_.GetAddress();
+        detail::Parallel_For(policy, size_, sizeof(T), [data](size_t first, size_t last) noexcept {
+            std::destroy_n(data + first, last - first);
+        });
+    }
+    size_ = 0;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::SwapStorage(Vector& other) noexcept {
+    Stats_Record_Peak();
+    other.Stats_Record_Peak();
+    data_.Swap(other.data_);
     std::swap(size_, other.size_);
 }
 
-template <typename T>
-void Vector<T>::Resize(size_t new_size) {
-    Reserve(new_size);
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Swap(Vector& other) noexcept {
+    // Без распространения аллокаторов обмен определён только для векторов с равными аллокаторами
+    SwapStorage(other);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Resize(size_t new_size) {
+    Stats_Record_Peak();
+    Grow_To(new_size);
     if (size_ > new_size) {
-        std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+        detail::Destroy_N(data_.GetAddress() + new_size, size_ - new_size);
     } else if (size_ < new_size) {
-        std::uninitialized_value_construct_n(data_.GetAddress() + size_, new_size - size_);
+        detail::Uninitialized_Value_Construct_N(data_.GetAddress() + size_, new_size - size_);
     }
     size_ = new_size;
+    Auto_Shrink();
 }
 
-template <typename T>
-void Vector<T>::PushBack(const T& value) {
-    if (size_ == Capacity()) {
-        if (size_ == 0) {
-            Reserve(1);
-            new (data_.GetAddress() + size_) T(value);
-        } else {
-            RawMemory<T> new_data(size_ * 2);
-            new (new_data.GetAddress() + size_) T(value);
-            Uninitialized_Move_Or_Copy_N(data_.GetAddress(), size_, new_data.GetAddress());
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
-        }
-    } else {
-        new (data_.GetAddress() + size_) T(value);
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::ResizeDefaultInit(size_t new_size) {
+    static_assert(detail::is_implicit_lifetime_v<T>, "ResizeDefaultInit requires an implicit-lifetime type");
+    Stats_Record_Peak();
+    Grow_To(new_size);
+    if (size_ > new_size) {
+        detail::Destroy_N(data_.GetAddress() + new_size, size_ - new_size);
+    } else if (size_ < new_size) {
+        std::uninitialized_default_construct_n(data_.GetAddress() + size_, new_size - size_);
     }
-    ++size_;
+    size_ = new_size;
+    Auto_Shrink();
 }
 
-template <typename T>
-void Vector<T>::PushBack(T&& value) {
-    if (size_ == Capacity()) {
-        if (size_ == 0) {
-            Reserve(1);
-            new (data_.GetAddress() + size_) T(std::move(value));
+template <typename T, typename Allocator, typename GrowthPolicy>
+Span<T> Vector<T, Allocator, GrowthPolicy>::AppendUninitialized(size_t count) {
+    static_assert(detail::is_implicit_lifetime_v<T>, "AppendUninitialized requires an implicit-lifetime type");
+    if (size_ + count > Capacity()) {
+        Grow_To(Next_Capacity(size_ + count));
+    }
+    Span<T> appended(data_.GetAddress() + size_, count);
+    size_ += count;
+    return appended;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+Span<T> Vector<T, Allocator, GrowthPolicy>::OpenGap(const_iterator pos, size_t count) {
+    static_assert(detail::is_implicit_lifetime_v<T>, "OpenGap requires an implicit-lifetime type");
+    assert(pos >= begin() && pos <= end());
+    const size_t pos_num = pos - begin();
+    if (size_ + count > Capacity()) {
+        if constexpr (REALLOCATES_IN_PLACE) {
+            data_.Reallocate(Next_Capacity(size_ + count));
+            Stats_Reallocated();
         } else {
-            RawMemory<T> new_data(size_ * 2);
-            new (new_data.GetAddress() + size_) T(std::move(value));
-            Uninitialized_Move_Or_Copy_N(data_.GetAddress(), size_, new_data.GetAddress());
-            std::destroy_n(data_.GetAddress(), size_);
+            // Части до и после промежутка переносятся в новый буфер сразу на свои места
+            RawMemory<T, Allocator> new_data(Next_Capacity(size_ + count), data_.GetAllocator());
+            detail::Uninitialized_Move_Or_Copy_N(begin(), pos_num, new_data.GetAddress());
+            try {
+                detail::Uninitialized_Move_Or_Copy_N(begin() + pos_num, size_ - pos_num, new_data.GetAddress() + (pos_num + count));
+            } catch (...) {
+                detail::Destroy_N(new_data.GetAddress(), pos_num);
+                throw;
+            }
+            detail::Destroy_N(begin(), size_);
             data_.Swap(new_data);
+            Stats_Reallocated();
+            size_ += count;
+            return Span<T>(begin() + pos_num, count);
         }
-    } else {
-        new (data_.GetAddress() + size_) T(std::move(value));
     }
-    ++size_;
+    Open_Gap(pos_num, count);
+    size_ += count;
+    return Span<T>(begin() + pos_num, count);
 }
 
-template <typename T>
-void Vector<T>::PopBack() {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::PushBack(const T& value) {
+    EmplaceBack(value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::PushBack(T&& value) {
+    EmplaceBack(std::move(value));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::PopBack() {
     if (size_ > 0){
+        Stats_Record_Peak();
         std::destroy_at(data_.GetAddress() + size_ - 1);
         --size_;
+        Auto_Shrink();
     }
 }
 
-template <typename T>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename... Args>
-T& Vector<T>::EmplaceBack(Args&&... args) {
+ADVANCED_VECTOR_CONSTEXPR T& Vector<T, Allocator, GrowthPolicy>::EmplaceBack(Args&&... args) {
+    if constexpr (REALLOCATES_IN_PLACE) {
+        return *Emplace_Relocating(size_, std::forward<Args>(args)...);
+    }
     if (size_ == Capacity()) {
-        if (size_ == 0) {
-            Reserve(1);
-            new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
-        } else {
-            RawMemory<T> new_data(size_ * 2);
-            new (new_data.GetAddress() + size_) T(std::forward<Args>(args)...);
-            Uninitialized_Move_Or_Copy_N(data_.GetAddress(), size_, new_data.GetAddress());
-            std::destroy_n(data_.GetAddress(), size_);
-            data_.Swap(new_data);
+        RawMemory<T, Allocator> new_data(Next_Capacity(size_ + 1), data_.GetAllocator());
+        T* elem = detail::Construct_At(new_data.GetAddress() + size_, std::forward<Args>(args)...);
+        try {
+            detail::Relocate_N(data_.GetAddress(), size_, new_data.GetAddress());
+        } catch (...) {
+            std::destroy_at(elem);
+            throw;
         }
+        data_.Swap(new_data);
+        Stats_Reallocated();
     } else {
-        new (data_.GetAddress() + size_) T(std::forward<Args>(args)...);
+        detail::Construct_At(data_.GetAddress() + size_, std::forward<Args>(args)...);
     }
     ++size_;
     return data_[size_ - 1];
 }
 
-template <typename T>
+template <typename T, typename Allocator, typename GrowthPolicy>
 template <typename... Args>
-typename Vector<T>::iterator Vector<T>::Emplace(const_iterator pos, Args&&... args) {
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Emplace(const_iterator pos, Args&&... args) {
     
     assert(pos >= begin() && pos <= end());
     
     auto elem_pos = begin();
-    auto pos_num = pos - begin();
+    const size_t pos_num = pos - begin();
     
+    if constexpr (REALLOCATES_IN_PLACE) {
+        return Emplace_Relocating(pos_num, std::forward<Args>(args)...);
+    }
     if (size_ == Capacity()) {
-        if (size_ == 0) {
-            Reserve(1);
-            elem_pos = new (end()) T(std::forward<Args>(args)...);
+        RawMemory<T, Allocator> new_data(Next_Capacity(size_ + 1), data_.GetAllocator());
+        elem_pos = detail::Construct_At(new_data.GetAddress() + pos_num, std::forward<Args>(args)...);
+    
+        if constexpr (is_trivially_relocatable_v<T>) {
+            detail::Relocate_N(begin(), pos_num, new_data.GetAddress());
+            detail::Relocate_N(begin() + pos_num, size_ - pos_num, new_data.GetAddress() + (pos_num + 1));
         } else {
-            RawMemory<T> new_data(size_ * 2);
-            elem_pos = new (new_data.GetAddress() + pos_num) T(std::forward<Args>(args)...);
-        
-            Uninitialized_Move_Or_Copy_N(begin(), pos_num, new_data.GetAddress());
-            Uninitialized_Move_Or_Copy_N(begin() + pos_num, size_ - pos_num, new_data.GetAddress() + (pos_num + 1));
-            
-            std::destroy_n(begin(), size_);
-            data_.Swap(new_data);
+            // Старые элементы разрушаются только после успешного копирования обеих частей
+            try {
+                detail::Uninitialized_Move_Or_Copy_N(begin(), pos_num, new_data.GetAddress());
+                try {
+                    detail::Uninitialized_Move_Or_Copy_N(begin() + pos_num, size_ - pos_num, new_data.GetAddress() + (pos_num + 1));
+                } catch (...) {
+                    detail::Destroy_N(new_data.GetAddress(), pos_num);
+                    throw;
+                }
+            } catch (...) {
+                std::destroy_at(elem_pos);
+                throw;
+            }
+            detail::Destroy_N(begin(), size_);
         }
+        data_.Swap(new_data);
+        Stats_Reallocated();
+    } else if (pos_num == size_) {
+        elem_pos = detail::Construct_At(end(), std::forward<Args>(args)...);
     } else {
-        if (size_ != 0) {
-            T temp = T(std::forward<Args>(args)...);
-            new (end()) T(std::forward<T>(*(end() - 1)));
-            std::move_backward(begin() + pos_num, end() - 1, end());
-            elem_pos = begin() + pos_num;
-            *elem_pos = std::forward<T>(temp);
+        if constexpr (is_trivially_relocatable_v<T>) {
+            // Во время компиляции memmove недоступен, и элементы сдвигаются перемещением
+            if (!detail::Is_Constant_Evaluated()) {
+                return Emplace_Relocating(pos_num, std::forward<Args>(args)...);
+            }
+        } else if constexpr (RELOCATES_NOTHROW) {
+            if (!detail::Is_Constant_Evaluated() && !Args_Alias(begin() + pos_num, args...)) {
+                elem_pos = begin() + pos_num;
+                Open_Gap(pos_num, 1);
+                try {
+                    detail::Construct_At(elem_pos, std::forward<Args>(args)...);
+                } catch (...) {
+                    Close_Empty_Gap(pos_num, 1);
+                    throw;
+                }
+                ++size_;
+                return elem_pos;
+            }
+        }
+        // Аргументы ссылаются на сдвигаемые элементы или хвост нельзя перенести без исключений:
+        // элемент создаётся до сдвига
+        T temp = T(std::forward<Args>(args)...);
+        detail::Construct_At(end(), std::forward<T>(*(end() - 1)));
+        std::move_backward(begin() + pos_num, end() - 1, end());
+        elem_pos = begin() + pos_num;
+        *elem_pos = std::forward<T>(temp);
+    }
+    ++size_;
+    return elem_pos;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+ADVANCED_VECTOR_CONSTEXPR T& Vector<T, Allocator, GrowthPolicy>::EmplaceAt(size_t index, Args&&... args) {
+    assert(index <= size_);
+    return *Emplace(begin() + index, std::forward<Args>(args)...);
+}
+
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Emplace_Relocating(size_t pos_num, Args&&... args) {
+    const bool grows = size_ == Capacity();
+    // Рост через reallocate может перенести весь буфер, без роста сдвигается только хвост
+    if (Args_Alias(grows ? begin() : begin() + pos_num, args...)) {
+        // Аргумент ссылается на переносимый элемент: элемент создаётся до сдвига и роста буфера
+        alignas(T) unsigned char temp[sizeof(T)];
+        T* elem = new (temp) T(std::forward<Args>(args)...);
+        if constexpr (REALLOCATES_IN_PLACE) {
+            if (grows) {
+                try {
+                    data_.Reallocate(Next_Capacity(size_ + 1));
+                    Stats_Reallocated();
+                } catch (...) {
+                    std::destroy_at(elem);
+                    throw;
+                }
+            }
         } else {
-            elem_pos = new (begin() + pos_num) T(std::forward<Args>(args)...);
+            assert(!grows);
+        }
+        auto elem_pos = begin() + pos_num;
+        std::memmove(static_cast<void*>(elem_pos + 1), static_cast<const void*>(elem_pos), (size_ - pos_num) * sizeof(T));
+        std::memcpy(static_cast<void*>(elem_pos), temp, sizeof(T));
+        ++size_;
+        return elem_pos;
+    }
+    if constexpr (REALLOCATES_IN_PLACE) {
+        if (grows) {
+            data_.Reallocate(Next_Capacity(size_ + 1));
+            Stats_Reallocated();
         }
+    } else {
+        assert(!grows);
+    }
+    auto elem_pos = begin() + pos_num;
+    Open_Gap(pos_num, 1);
+    try {
+        detail::Construct_At(elem_pos, std::forward<Args>(args)...);
+    } catch (...) {
+        Close_Empty_Gap(pos_num, 1);
+        throw;
     }
     ++size_;
     return elem_pos;
 }
 
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+bool Vector<T, Allocator, GrowthPolicy>::Args_Alias(const T* first, const Args&... args) const noexcept {
+    [[maybe_unused]] const auto points_into = [first, last = end()](const auto& arg) noexcept {
+        if constexpr (std::is_function_v<std::remove_reference_t<decltype(arg)>>) {
+            return false;
+        } else {
+            const void* address = std::addressof(arg);
+            return !std::less<const void*>()(address, first) && std::less<const void*>()(address, last);
+        }
+    };
+    return (points_into(args) || ...);
+}
 
-template <typename T>
-typename Vector<T>::iterator Vector<T>::Insert(const_iterator pos, const T& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Open_Gap(size_t pos_num, size_t count) noexcept {
+    static_assert(RELOCATES_NOTHROW, "the tail is relocated without rollback");
+    assert(pos_num <= size_ && size_ + count <= Capacity());
+    T* gap = data_.GetAddress() + pos_num;
+    const size_t elems_after = size_ - pos_num;
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!detail::Is_Constant_Evaluated()) {
+            std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), elems_after * sizeof(T));
+            return;
+        }
+    }
+    // Элементы переносятся с конца, поэтому каждый попадает в уже освободившуюся ячейку
+    for (size_t i = elems_after; i > 0; --i) {
+        detail::Construct_At(gap + count + (i - 1), std::move(gap[i - 1]));
+        std::destroy_at(gap + (i - 1));
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Close_Empty_Gap(size_t pos_num, size_t count) noexcept {
+    T* gap = data_.GetAddress() + pos_num;
+    const size_t elems_after = size_ - pos_num;
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!detail::Is_Constant_Evaluated()) {
+            std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), elems_after * sizeof(T));
+            return;
+        }
+    }
+    for (size_t i = 0; i < elems_after; ++i) {
+        detail::Construct_At(gap + i, std::move(gap[count + i]));
+        std::destroy_at(gap + count + i);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Insert(const_iterator pos, const T& value) {
     return Emplace(pos, value);
 }
 
-template <typename T>
-typename Vector<T>::iterator Vector<T>::Insert(const_iterator pos, T&& value) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Insert(const_iterator pos, T&& value) {
     return Emplace(pos, std::move(value));
 }
 
-template <typename T>
-typename Vector<T>::iterator Vector<T>::Erase(const_iterator pos) {
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename InputIt, typename>
+typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Insert(const_iterator pos, InputIt first, InputIt last) {
+
+    assert(pos >= begin() && pos <= end());
+
+    const size_t pos_num = pos - begin();
+    if constexpr (detail::is_forward_iterator_v<InputIt>) {
+        const size_t count = std::distance(first, last);
+        if constexpr (std::is_pointer_v<InputIt>) {
+            if (count != 0 && Overlaps(&*first, &*first + count)) {
+                // Диапазон взят из самого вектора: сначала он копируется во временный вектор
+                Vector copy(data_.GetAllocator());
+                copy.Insert_From(0, count, detail::RangeSource<T, InputIt>{first});
+                return Insert_From(pos_num, count, detail::RangeSource<T, std::move_iterator<iterator>>{std::make_move_iterator(copy.begin())});
+            }
+        }
+        return Insert_From(pos_num, count, detail::RangeSource<T, InputIt>{first});
+    } else {
+        const size_t old_size = size_;
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+        std::rotate(begin() + pos_num, begin() + old_size, end());
+        return begin() + pos_num;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Insert(const_iterator pos, size_t count, const T& value) {
+
+    assert(pos >= begin() && pos <= end());
+
+    const size_t pos_num = pos - begin();
+    if (Overlaps(&value, &value + 1)) {
+        const T copy(value);
+        return Insert_From(pos_num, count, detail::FillSource<T>{copy});
+    }
+    return Insert_From(pos_num, count, detail::FillSource<T>{value});
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename InputIt, typename>
+void Vector<T, Allocator, GrowthPolicy>::Append(InputIt first, InputIt last) {
+    Insert(cend(), first, last);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Insert(const_iterator pos, ConstSpan<T> values) {
+    return Insert(pos, values.begin(), values.end());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Vector<T, Allocator, GrowthPolicy>::Append(ConstSpan<T> values) {
+    Insert(cend(), values.begin(), values.end());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename Range>
+void Vector<T, Allocator, GrowthPolicy>::AppendRange(const Range& range) {
+    using std::begin;
+    using std::end;
+    Append(begin(range), end(range));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename Source>
+typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Insert_From(size_t pos_num, size_t count, const Source& source) {
+    if (count == 0) {
+        return begin() + pos_num;
+    }
+    if (size_ + count > Capacity()) {
+        if constexpr (REALLOCATES_IN_PLACE) {
+            data_.Reallocate(Next_Capacity(size_ + count));
+            Stats_Reallocated();
+        } else {
+            // Новые элементы создаются в новом буфере до переноса старых
+            RawMemory<T, Allocator> new_data(Next_Capacity(size_ + count), data_.GetAllocator());
+            T* gap = new_data.GetAddress() + pos_num;
+            source.Construct(gap, 0, count);
+            if constexpr (is_trivially_relocatable_v<T>) {
+                detail::Relocate_N(begin(), pos_num, new_data.GetAddress());
+                detail::Relocate_N(begin() + pos_num, size_ - pos_num, gap + count);
+            } else {
+                // Старые элементы разрушаются только после успешного копирования обеих частей
+                try {
+                    detail::Uninitialized_Move_Or_Copy_N(begin(), pos_num, new_data.GetAddress());
+                    try {
+                        detail::Uninitialized_Move_Or_Copy_N(begin() + pos_num, size_ - pos_num, gap + count);
+                    } catch (...) {
+                        std::destroy_n(new_data.GetAddress(), pos_num);
+                        throw;
+                    }
+                } catch (...) {
+                    std::destroy_n(gap, count);
+                    throw;
+                }
+                std::destroy_n(begin(), size_);
+            }
+            data_.Swap(new_data);
+            Stats_Reallocated();
+            size_ += count;
+            return gap;
+        }
+    }
+
+    T* gap = begin() + pos_num;
+    const size_t elems_after = size_ - pos_num;
+    if constexpr (is_trivially_relocatable_v<T>) {
+        // Хвост сдвигается одним memmove; если создание элементов не удалось, он возвращается на место
+        std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), elems_after * sizeof(T));
+        try {
+            source.Construct(gap, 0, count);
+        } catch (...) {
+            std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), elems_after * sizeof(T));
+            throw;
+        }
+        size_ += count;
+    } else {
+        T* old_end = end();
+        if (elems_after > count) {
+            std::uninitialized_move(old_end - count, old_end, old_end);
+            size_ += count;
+            std::move_backward(gap, old_end - count, old_end);
+            source.Assign(gap, 0, count);
+        } else {
+            source.Construct(old_end, elems_after, count - elems_after);
+            size_ += count - elems_after;
+            std::uninitialized_move(gap, old_end, end());
+            size_ += elems_after;
+            source.Assign(gap, 0, elems_after);
+        }
+    }
+    return gap;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Erase(const_iterator pos) {
     
     assert(pos >= begin() && pos <= end());
     
+    Stats_Record_Peak();
     auto elem_pos = begin() + (pos - begin());
-    std::move(elem_pos + 1, end(), elem_pos);
-    std::destroy_at(end() - 1);
+    Close_Gap(elem_pos, 1);
     --size_;
-    return elem_pos;
+    // Сжатие может перенести элементы в новый буфер
+    const size_t index = elem_pos - begin();
+    Auto_Shrink();
+    return begin() + index;
+}
+
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR typename Vector<T, Allocator, GrowthPolicy>::iterator Vector<T, Allocator, GrowthPolicy>::Erase(const_iterator first, const_iterator last) {
+
+    assert(first >= begin() && first <= last && last <= end());
+
+    auto elem_pos = begin() + (first - begin());
+    const size_t count = last - first;
+    if (count == 0) {
+        return elem_pos;
+    }
+    Stats_Record_Peak();
+    Close_Gap(elem_pos, count);
+    size_ -= count;
+    const size_t index = elem_pos - begin();
+    Auto_Shrink();
+    return begin() + index;
 }
 
+template <typename T, typename Allocator, typename GrowthPolicy>
+ADVANCED_VECTOR_CONSTEXPR void Vector<T, Allocator, GrowthPolicy>::Close_Gap(iterator first, size_t count) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        if (!detail::Is_Constant_Evaluated()) {
+            detail::Destroy_N(first, count);
+            std::memmove(static_cast<void*>(first), static_cast<const void*>(first + count), (end() - first - count) * sizeof(T));
+            return;
+        }
+    }
+    std::move(first + count, end(), first);
+    detail::Destroy_N(end() - count, count);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+template <typename Predicate>
+size_t Vector<T, Allocator, GrowthPolicy>::EraseIf(Predicate pred) {
+    Stats_Record_Peak();
+    iterator new_end = begin();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        // Уплотнение без ветвлений: каждый элемент копируется, а позиция записи сдвигается,
+        // только если элемент остаётся
+        for (iterator it = begin(); it != end(); ++it) {
+            const bool keep = !pred(std::as_const(*it));
+            *new_end = *it;
+            new_end += keep;
+        }
+    } else {
+        new_end = std::remove_if(begin(), end(), [&pred](const T& value) {
+            return pred(value);
+        });
+    }
+    const size_t erased = end() - new_end;
+    detail::Destroy_N(new_end, erased);
+    size_ -= erased;
+    Auto_Shrink();
+    return erased;
+}
 
@@ -0,0 +1,119 @@
+#pragma once
+#include "vector.h"
+
+// Пул векторов для повторного использования буферов. Acquire выдаёт пустой Vector с вместимостью
+// не меньше initial_capacity: возвращённый ранее, если он есть, иначе новый. Когда Lease разрушается
+// (или вектор отдан через Release), элементы разрушаются, а буфер остаётся в пуле, поэтому в устойчивом
+// режиме получение, заполнение и возврат вектора не выделяют память.
+// Память пула ограничена: хранится не больше max_retained векторов, а вектор, выросший больше
+// max_retained_capacity элементов или меньший initial_capacity, при возврате освобождается.
+// Пул не потокобезопасен, обычно у каждого потока свой; он должен пережить выданные Lease
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class VectorPool {
+public:
+    using Pooled = Vector<T, Allocator, GrowthPolicy>;
+
+    // Вектор из пула; при разрушении возвращается в пул
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr))
+            , vector_(std::move(other.vector_)) {
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        ~Lease() {
+            if (pool_ != nullptr) {
+                pool_->Release(std::move(vector_));
+            }
+        }
+
+        Pooled& operator*() noexcept {
+            return vector_;
+        }
+
+        Pooled* operator->() noexcept {
+            return &vector_;
+        }
+
+    private:
+        friend class VectorPool;
+
+        Lease(VectorPool& pool, Pooled&& vector) noexcept
+            : pool_(&pool)
+            , vector_(std::move(vector)) {
+        }
+
+        VectorPool* pool_;
+        Pooled vector_;
+    };
+
+    static constexpr size_t DEFAULT_MAX_RETAINED = 16;
+
+    // max_retained_capacity по умолчанию не ограничивает вместимость возвращаемых векторов
+    explicit VectorPool(size_t initial_capacity, size_t max_retained = DEFAULT_MAX_RETAINED,
+                        size_t max_retained_capacity = SIZE_MAX, const Allocator& alloc = Allocator());
+
+    VectorPool(const VectorPool&) = delete;
+    VectorPool& operator=(const VectorPool&) = delete;
+
+    Lease Acquire();
+    // Возвращает в пул вектор, в том числе созданный вне пула; элементы разрушаются
+    void Release(Pooled&& vector) noexcept;
+
+    // Число векторов, ожидающих повторной выдачи
+    size_t Retained() const noexcept {
+        return free_.Size();
+    }
+
+    // Освобождает буферы всех хранимых векторов
+    void Trim() noexcept {
+        free_.Clear();
+    }
+
+private:
+    size_t initial_capacity_;
+    size_t max_retained_;
+    size_t max_retained_capacity_;
+    Allocator alloc_;
+    // Вместимость зарезервирована под max_retained векторов, поэтому Release не выделяет память
+    Vector<Pooled> free_;
+};
+
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+VectorPool<T, Allocator, GrowthPolicy>::VectorPool(size_t initial_capacity, size_t max_retained,
+                                                   size_t max_retained_capacity, const Allocator& alloc)
+    : initial_capacity_(initial_capacity)
+    , max_retained_(max_retained)
+    , max_retained_capacity_(max_retained_capacity)
+    , alloc_(alloc) //
+{
+    free_.Reserve(max_retained_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename VectorPool<T, Allocator, GrowthPolicy>::Lease VectorPool<T, Allocator, GrowthPolicy>::Acquire() {
+    if (free_.Size() == 0) {
+        Pooled vector(alloc_);
+        vector.Reserve(initial_capacity_);
+        return Lease(*this, std::move(vector));
+    }
+    // Перемещающий конструктор забирает буфер при любом аллокаторе, присваивание могло бы его скопировать
+    Lease lease(*this, std::move(free_[free_.Size() - 1]));
+    free_.PopBack();
+    return lease;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void VectorPool<T, Allocator, GrowthPolicy>::Release(Pooled&& vector) noexcept {
+    // Clear сохраняет вместимость
+    vector.Clear();
+    if (free_.Size() < max_retained_ && vector.Capacity() >= initial_capacity_ && vector.Capacity() != 0
+        && vector.Capacity() <= max_retained_capacity_) {
+        free_.PushBack(std::move(vector));
+    }
+}